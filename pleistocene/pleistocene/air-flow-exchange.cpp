@@ -0,0 +1,142 @@
+#include "air-flow-exchange.h"
+#include "shared-surface.h"
+#include "worker-pool.h"
+#include <unordered_map>
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+using layers::elements::GaseousMixture;
+
+AirFlowExchange::AirFlowExchange() noexcept {}
+
+namespace {
+void forEachTileRange(my::WorkerPool *pool, int tileCount, const std::function<void(int, int)> &task) noexcept
+{
+	if (pool) { pool->run(tileCount, task); }
+	else { task(0, tileCount); }
+}
+}
+
+void AirFlowExchange::build(const std::vector<layers::MaterialColumn*> &columns, my::WorkerPool *pool) noexcept
+{
+	int tileCount = int(columns.size());
+
+	_layers.clear();
+	_layerOffsets.assign(1, 0);
+	_surfaceOffsets.assign(1, 0);
+
+	//air layers column by column, each counting the surfaces it owns
+	std::unordered_map<const layers::MaterialLayer*, int> layerIndices;
+	for (int tile = 0; tile < tileCount; tile++) {
+		for (layers::MaterialLayer *layer : columns[tile]->getColumn()) {
+			if (layer->getType() != layers::AIR) continue;
+
+			layers::AirLayer *air = static_cast<layers::AirLayer*>(layer);
+			layerIndices[layer] = int(_layers.size());
+			_layers.push_back(air);
+			_surfaceOffsets.push_back(_surfaceOffsets.back() + int(air->getSharedAirSurfaces().size()));
+		}
+		_layerOffsets.push_back(int(_layers.size()));
+	}
+
+	int layerCount = int(_layers.size());
+	int surfaceCount = _surfaceOffsets.back();
+	_surfaces.assign(surfaceCount, nullptr);
+	_tenants.assign(surfaceCount, my::kFakeIndex);
+
+	forEachTileRange(pool, tileCount, [this, &layerIndices](int begin, int end) {
+		for (int layer = _layerOffsets[begin]; layer < _layerOffsets[end]; layer++) {
+			int surface = _surfaceOffsets[layer];
+			for (layers::SharedAirSurface &airSurface : _layers[layer]->getSharedAirSurfaces()) {
+				_surfaces[surface] = &airSurface;
+				_tenants[surface] = layerIndices.at(airSurface.getTenant());
+				surface++;
+			}
+		}
+	});
+
+	//every surface touches its owner and its tenant. counted first, then filled in surface order
+	std::vector<int> incidentCounts(layerCount, 0);
+	for (int layer = 0; layer < layerCount; layer++) {
+		for (int surface = _surfaceOffsets[layer]; surface < _surfaceOffsets[layer + 1]; surface++) {
+			incidentCounts[layer]++;
+			incidentCounts[_tenants[surface]]++;
+		}
+	}
+
+	_incidentOffsets.assign(1, 0);
+	_maxShare.assign(layerCount, 1);
+	for (int layer = 0; layer < layerCount; layer++) {
+		_incidentOffsets.push_back(_incidentOffsets.back() + incidentCounts[layer]);
+		if (incidentCounts[layer] > 0) _maxShare[layer] = 1.0 / incidentCounts[layer];
+	}
+
+	_incidentSurfaces.assign(_incidentOffsets.back(), my::kFakeIndex);
+	std::vector<int> filled(_incidentOffsets.begin(), _incidentOffsets.end() - 1);
+	for (int layer = 0; layer < layerCount; layer++) {
+		for (int surface = _surfaceOffsets[layer]; surface < _surfaceOffsets[layer + 1]; surface++) {
+			_incidentSurfaces[filled[layer]++] = surface;
+			_incidentSurfaces[filled[_tenants[surface]]++] = surface;
+		}
+	}
+
+	_fluxes.assign(surfaceCount, AirFlux());
+	_frozen.assign(layerCount, layers::elements::FrozenGas());
+}
+
+bool AirFlowExchange::isBuilt() const noexcept { return _layerOffsets.size() > 1; }
+
+void AirFlowExchange::computeFluxes(int tile) noexcept
+{
+	for (int layer = _layerOffsets[tile]; layer < _layerOffsets[tile + 1]; layer++) {
+		GaseousMixture &gas = *_layers[layer]->getGasPtr();
+		_frozen[layer] = gas.freeze();
+
+		for (int surface = _surfaceOffsets[layer]; surface < _surfaceOffsets[layer + 1]; surface++) {
+			int tenant = _tenants[surface];
+			AirFlux &flux = _fluxes[surface];
+
+			//the surface sees the inertias as they were, plus only its own kick
+			Eigen::Vector3d ownerInertia = gas.getInertia();
+			Eigen::Vector3d tenantInertia = _layers[tenant]->getGasPtr()->getInertia();
+			double netFlux = _surfaces[surface]->computeFlux(ownerInertia, tenantInertia, flux.kick);
+
+			//as in SharedAirSurface::flow, a negative flux runs from the tenant to the owner
+			bool backflow = std::signbit(netFlux);
+			flux.giver = backflow ? tenant : layer;
+			flux.receiver = backflow ? layer : tenant;
+			flux.share = std::min(std::abs(netFlux), _maxShare[flux.giver]);
+		}
+	}
+}
+
+void AirFlowExchange::applyFluxes(int tile) noexcept
+{
+	for (int layer = _layerOffsets[tile]; layer < _layerOffsets[tile + 1]; layer++) {
+		GaseousMixture &gas = *_layers[layer]->getGasPtr();
+		gas._netFlow = 0;
+
+		double given = 0;
+		Eigen::Vector3d kicks(0, 0, 0);
+		for (int i = _incidentOffsets[layer]; i < _incidentOffsets[layer + 1]; i++) {
+			const AirFlux &flux = _fluxes[_incidentSurfaces[i]];
+			if (flux.giver == layer) given += flux.share;
+			kicks += flux.kick;
+		}
+
+		gas.resizeBy(1 - given);
+
+		for (int i = _incidentOffsets[layer]; i < _incidentOffsets[layer + 1]; i++) {
+			const AirFlux &flux = _fluxes[_incidentSurfaces[i]];
+			if (flux.receiver == layer && flux.share > 0) gas.receiveShare(_frozen[flux.giver], flux.share);
+		}
+
+		gas.setInertia(gas.getInertia() + kicks);
+	}
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
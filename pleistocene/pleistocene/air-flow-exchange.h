@@ -0,0 +1,60 @@
+#pragma once
+#include "globals.h"
+#include "material-column.h"
+
+namespace pleistocene {
+namespace my { class WorkerPool; }
+namespace simulation {
+namespace climate {
+
+//One air surface's exchange this step
+struct AirFlux {
+	int giver;//layer indices in the AirFlowExchange
+	int receiver;
+	double share;//of the giver's gas
+	Eigen::Vector3d kick;//pressure push on both layers' inertia
+};
+
+//TWO_PHASE_AIR_FLOW over the world's air layers, flattened.
+//computeFluxes works every surface's flux out from the state the step starts from (SharedAirSurface::computeFlux) into
+//_fluxes and freezes each layer's gas. applyFluxes then has every layer keep what it didn't give and gather its givers'
+//shares from their frozen copies, in surface order. No layer is read while another task writes it, so tiles may run in any
+//order or all at once and the result is the same.
+//A surface takes at most 1/n of its giver (n surfaces touching it), so a layer never gives more than it holds
+class AirFlowExchange {
+public:
+	AirFlowExchange() noexcept;
+
+	//columns indexed by tile. must be rebuilt whenever layers or surfaces are rebuilt.
+	//the per tile parts run on pool when given
+	void build(const std::vector<layers::MaterialColumn*> &columns, my::WorkerPool *pool = nullptr) noexcept;
+	bool isBuilt() const noexcept;
+
+	//phase 1: fluxes through the surfaces the tile's air layers own, and the frozen gas of those layers.
+	//reads the tile and its neighbors, writes the tile's own entries
+	void computeFluxes(int tile) noexcept;
+	//phase 2, once the tile and its neighbors are through phase 1: updates the tile's air layers
+	void applyFluxes(int tile) noexcept;
+
+private:
+	//tile by tile, bottom to top. _layers[_layerOffsets[tile].._layerOffsets[tile+1])
+	std::vector<layers::AirLayer*> _layers;
+	std::vector<int> _layerOffsets;
+	std::vector<double> _maxShare;//by layer
+
+	//layer by layer, each layer's own surfaces. _surfaces[_surfaceOffsets[layer].._surfaceOffsets[layer+1])
+	std::vector<layers::SharedAirSurface*> _surfaces;
+	std::vector<int> _surfaceOffsets;
+	std::vector<int> _tenants;//by surface
+
+	//surfaces touching each layer, its own and those it is the tenant of, in surface order
+	std::vector<int> _incidentOffsets;
+	std::vector<int> _incidentSurfaces;
+
+	std::vector<AirFlux> _fluxes;//by surface
+	std::vector<layers::elements::FrozenGas> _frozen;//by layer
+};
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,414 @@
+#include "band-decomposition.h"
+#include "profiler.h"
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <thread>
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace pleistocene {
+namespace simulation {
+
+namespace {
+
+//room for mixtures gaining elements (and clouds) after the slots were sized
+const size_t kSlotSlack = 4096;
+
+const size_t kSharedAlignment = 64;
+size_t alignShared(size_t bytes) noexcept { return (bytes + kSharedAlignment - 1) / kSharedAlignment * kSharedAlignment; }
+
+//a barrier yields this many times before it starts sleeping and checking on the other bands
+const int kBusySpins = 2000;
+const int kPollMicroseconds = 50;
+
+#ifndef _WIN32
+bool writeAll(int file, const char *data, size_t size) noexcept
+{
+	while (size > 0) {
+		ssize_t written = write(file, data, size);
+		if (written < 0 && errno == EINTR) continue;
+		if (written <= 0) return false;
+		data += written;
+		size -= size_t(written);
+	}
+	return true;
+}
+
+bool readAll(int file, char *data, size_t size) noexcept
+{
+	while (size > 0) {
+		ssize_t bytesRead = read(file, data, size);
+		if (bytesRead < 0 && errno == EINTR) continue;
+		if (bytesRead <= 0) return false;
+		data += bytesRead;
+		size -= size_t(bytesRead);
+	}
+	return true;
+}
+#endif
+
+}//namespace
+
+struct BandDecomposition::SharedState {
+	std::atomic<int> _arrived;
+	std::atomic<int> _generation;
+	std::atomic<int> _failed;
+};
+
+//======================================
+//SETUP
+//======================================
+
+BandDecomposition::BandDecomposition(int bandCount, const TileColoring &coloring, const NeighborGraph &graph) noexcept :
+_bandCount(bandCount),
+_colorCount(coloring.getColorCount())
+{
+	int rows = my::Address::GetRows();
+	int cols = my::Address::GetCols();
+	int tileCount = rows*cols;
+	if (bandCount < 1 || bandCount > rows) { LOG("Can't split " << rows << " rows into " << bandCount << " bands"); exit(EXIT_FAILURE); }
+
+	std::vector<int> bandOf(tileCount);
+	_ownTiles.assign(_bandCount, std::vector<int>());
+	for (int band = 0; band < _bandCount; band++) {
+		for (int row = band*rows / _bandCount; row < (band + 1)*rows / _bandCount; row++) {
+			for (int col = 0; col < cols; col++) {
+				int tile = my::Address(row, col).i;
+				bandOf[tile] = band;
+				_ownTiles[band].push_back(tile);
+			}
+		}
+	}
+
+	_ownTilesByColor.assign(_bandCount, std::vector<std::vector<int>>(_colorCount));
+	for (int color = 0; color < _colorCount; color++) {
+		for (int tile : coloring.getColorClass(color)) {
+			_ownTilesByColor[bandOf[tile]][color].push_back(tile);
+		}
+	}
+
+	//kernels reach no further than the adjacent tiles
+	_touchedTiles.assign(_bandCount, std::vector<int>());
+	_bandsTouching.assign(tileCount, std::vector<int>());
+	std::vector<bool> touched;
+	for (int band = 0; band < _bandCount; band++) {
+		touched.assign(tileCount, false);
+		for (int tile : _ownTiles[band]) {
+			touched[tile] = true;
+			const int32_t *neighbors = graph.getNeighbors(tile);
+			for (int direction = 0; direction < NeighborGraph::kDirections; direction++) {
+				if (neighbors[direction] != NeighborGraph::kNoNeighbor) touched[neighbors[direction]] = true;
+			}
+		}
+		for (int tile = 0; tile < tileCount; tile++) {
+			if (!touched[tile]) continue;
+			_touchedTiles[band].push_back(tile);
+			_bandsTouching[tile].push_back(band);
+		}
+	}
+
+	//who writes each tile in each phase: the owner in tile-local steps, the band of the kernel whose write set holds it in a color class
+	_phaseWriters.assign(_colorCount + 1, std::vector<int>(tileCount, my::kFakeIndex));
+	_phaseWriters[kLocalPhase + 1] = bandOf;
+	for (int color = 0; color < _colorCount; color++) {
+		for (int tile : coloring.getColorClass(color)) {
+			for (int written : TileColoring::writeSet(graph, tile)) {
+				_phaseWriters[color + 1][written] = bandOf[tile];
+			}
+		}
+	}
+
+	//a tile needs a slot if some phase's writer isn't the only band touching it
+	_slotOf.assign(tileCount, my::kFakeIndex);
+	for (const std::vector<int> &writers : _phaseWriters) {
+		for (int tile = 0; tile < tileCount; tile++) {
+			if (_slotOf[tile] != my::kFakeIndex || writers[tile] == my::kFakeIndex) continue;
+			for (int band : _bandsTouching[tile]) {
+				if (band != writers[tile]) { _slotOf[tile] = _slotCount++; break; }
+			}
+		}
+	}
+}
+
+BandDecomposition::~BandDecomposition() noexcept
+{
+#ifndef _WIN32
+	if (_band == 0 && _shared) {
+		//bands still running (finish was never reached) stop at their next barrier
+		sharedState()._failed.store(1);
+		reapBands();
+	}
+	if (_shared) munmap(_shared, _sharedSize);
+#endif
+}
+
+bool BandDecomposition::start(const std::function<size_t(int tile)> &stateSize) noexcept
+{
+#ifdef _WIN32
+	LOG("Latitude bands need fork and shared memory, which this build doesn't have");
+	return false;
+#else
+	size_t largest = 0;
+	for (int tile = 0; tile < int(_slotOf.size()); tile++) {
+		if (_slotOf[tile] != my::kFakeIndex) largest = std::max(largest, stateSize(tile));
+	}
+	_slotCapacity = alignShared(2 * largest + kSlotSlack);
+
+	_sharedSize = alignShared(sizeof(SharedState)) + alignShared(2 * _slotCount * sizeof(uint64_t)) + 2 * _slotCount * _slotCapacity;
+	void *shared = mmap(nullptr, _sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED) { LOG("Could not map " << _sharedSize << " bytes for the band exchange"); _shared = nullptr; return false; }
+	_shared = static_cast<char*>(shared);
+
+	SharedState &state = *new (_shared) SharedState();
+	state._arrived.store(0);
+	state._generation.store(0);
+	state._failed.store(0);
+
+	//or the bands print whatever was still buffered again
+	std::cout.flush();
+	std::cerr.flush();
+	fflush(nullptr);
+
+	_firstProcess = int(getpid());
+	_processes.assign(_bandCount, 0);
+	_resultPipes.assign(_bandCount, -1);
+
+	for (int band = 1; band < _bandCount; band++) {
+		int pipeEnds[2];
+		if (pipe(pipeEnds) != 0) { LOG("Could not open a pipe for band " << band); state._failed.store(1); reapBands(); return false; }
+
+		pid_t process = fork();
+		if (process < 0) {
+			LOG("Could not start band " << band);
+			close(pipeEnds[0]);
+			close(pipeEnds[1]);
+			state._failed.store(1);
+			reapBands();
+			return false;
+		}
+
+		if (process == 0) {
+			_band = band;
+			close(pipeEnds[0]);
+			for (int other = 1; other < band; other++) close(_resultPipes[other]);
+			_resultPipes.assign(_bandCount, -1);
+			_resultPipes[band] = pipeEnds[1];
+			_processes.assign(_bandCount, 0);
+			break;
+		}
+
+		close(pipeEnds[1]);
+		_processes[band] = int(process);
+		_resultPipes[band] = pipeEnds[0];
+	}
+
+	planPhases();
+	return true;
+#endif
+}
+
+void BandDecomposition::planPhases() noexcept
+{
+	_plans.assign(_colorCount + 1, PhasePlan());
+
+	for (int phase = 0; phase <= _colorCount; phase++) {
+		const std::vector<int> &writers = _phaseWriters[phase];
+		PhasePlan &plan = _plans[phase];
+
+		for (int tile = 0; tile < int(writers.size()); tile++) {
+			if (writers[tile] != _band || _slotOf[tile] == my::kFakeIndex) continue;
+			for (int band : _bandsTouching[tile]) {
+				if (band != _band) { plan._sends.push_back(tile); break; }
+			}
+		}
+
+		for (int tile : _touchedTiles[_band]) {
+			if (writers[tile] != _band && writers[tile] != my::kFakeIndex) plan._receives.push_back(tile);
+		}
+	}
+}
+
+//======================================
+//GETTERS
+//======================================
+
+int BandDecomposition::getBand() const noexcept { return _band; }
+
+const std::vector<int> &BandDecomposition::getOwnTiles() const noexcept { return _ownTiles[_band]; }
+
+const std::vector<int> &BandDecomposition::getOwnTiles(int color) const noexcept { return _ownTilesByColor[_band][color]; }
+
+const std::vector<int> &BandDecomposition::getTouchedTiles() const noexcept { return _touchedTiles[_band]; }
+
+//======================================
+//EXCHANGE
+//======================================
+
+void BandDecomposition::exchange(int phase, const TileWriter &write, const TileReader &read) noexcept
+{
+	my::ScopedTimer timer("band exchange");
+
+	const PhasePlan &plan = _plans[phase + 1];
+	int bank = _exchangeCount++ % 2;
+
+	for (int tile : plan._sends) {
+		_writer.clear();
+		write(tile, _writer);
+		if (_writer.size() > _slotCapacity) {
+			LOG("State of tile " << tile << " (" << _writer.size() << " bytes) outgrew its band exchange slot (" << _slotCapacity << ")");
+			fail();
+		}
+		std::memcpy(slotData(bank, _slotOf[tile]), _writer.data(), _writer.size());
+		slotSize(bank, _slotOf[tile]) = _writer.size();
+	}
+
+	//phases alternate between two banks. this bank is written again two phases on, after the next barrier,
+	//which no band reaches before it has read this phase's tiles
+	barrier();
+
+	for (int tile : plan._receives) {
+		my::SnapshotReader reader;
+		reader.openBuffer(slotData(bank, _slotOf[tile]), size_t(slotSize(bank, _slotOf[tile])));
+		read(tile, reader);
+		if (!reader.atEnd()) { LOG("Band exchange of tile " << tile << " read a different size than was written"); fail(); }
+	}
+}
+
+bool BandDecomposition::finish(const TileWriter &write, const TileReader &read) noexcept
+{
+#ifdef _WIN32
+	return true;
+#else
+	if (_band != 0) {
+		_writer.clear();
+		for (int tile : _ownTiles[_band]) {
+			write(tile, _writer);
+		}
+		uint64_t size = _writer.size();
+		bool sent = writeAll(_resultPipes[_band], reinterpret_cast<const char*>(&size), sizeof(size)) &&
+			writeAll(_resultPipes[_band], _writer.data(), _writer.size());
+		_exit(sent ? EXIT_SUCCESS : EXIT_FAILURE);//no destructors or atexit handlers, those belong to band 0
+	}
+
+	std::vector<char> buffer;
+	for (int band = 1; band < _bandCount; band++) {
+		uint64_t size;
+		if (!readAll(_resultPipes[band], reinterpret_cast<char*>(&size), sizeof(size))) {
+			LOG("No result from band " << band); reapBands(); return false;
+		}
+		buffer.resize(size_t(size));
+		if (!readAll(_resultPipes[band], buffer.data(), buffer.size())) {
+			LOG("Truncated result from band " << band); reapBands(); return false;
+		}
+
+		my::SnapshotReader reader;
+		reader.openBuffer(buffer.data(), buffer.size());
+		for (int tile : _ownTiles[band]) {
+			read(tile, reader);
+		}
+		if (!reader.atEnd()) { LOG("Result of band " << band << " has a different size than its tiles"); reapBands(); return false; }
+	}
+
+	if (!reapBands()) { LOG("A band did not exit cleanly"); return false; }
+	return true;
+#endif
+}
+
+//======================================
+//SHARED MEMORY AND PROCESSES
+//======================================
+
+BandDecomposition::SharedState &BandDecomposition::sharedState() noexcept { return *reinterpret_cast<SharedState*>(_shared); }
+
+uint64_t &BandDecomposition::slotSize(int bank, int slot) noexcept
+{
+	return reinterpret_cast<uint64_t*>(_shared + alignShared(sizeof(SharedState)))[bank*_slotCount + slot];
+}
+
+char *BandDecomposition::slotData(int bank, int slot) noexcept
+{
+	size_t dataOffset = alignShared(sizeof(SharedState)) + alignShared(2 * _slotCount * sizeof(uint64_t));
+	return _shared + dataOffset + (size_t(bank)*_slotCount + slot)*_slotCapacity;
+}
+
+void BandDecomposition::barrier() noexcept
+{
+#ifndef _WIN32
+	SharedState &state = sharedState();
+	int generation = state._generation.load();
+
+	if (state._arrived.fetch_add(1) == _bandCount - 1) {
+		state._arrived.store(0);
+		state._generation.fetch_add(1);
+		return;
+	}
+
+	for (int spin = 0; state._generation.load() == generation; spin++) {
+		if (spin < kBusySpins) { std::this_thread::yield(); continue; }
+		usleep(kPollMicroseconds);
+		checkPeers();
+	}
+#endif
+}
+
+void BandDecomposition::fail() noexcept
+{
+#ifndef _WIN32
+	sharedState()._failed.store(1);
+	if (_band != 0) _exit(EXIT_FAILURE);
+	reapBands();
+#endif
+	exit(EXIT_FAILURE);
+}
+
+void BandDecomposition::checkPeers() noexcept
+{
+#ifndef _WIN32
+	if (_band != 0) {
+		if (sharedState()._failed.load() || int(getppid()) != _firstProcess) _exit(EXIT_FAILURE);
+		return;
+	}
+
+	if (sharedState()._failed.load()) { LOG("A band failed"); fail(); }
+
+	for (int band = 1; band < _bandCount; band++) {
+		if (_processes[band] == 0) continue;
+		int status;
+		if (waitpid(_processes[band], &status, WNOHANG) == _processes[band]) {
+			_processes[band] = 0;
+			LOG("Band " << band << " stopped before the run finished");
+			fail();
+		}
+	}
+#endif
+}
+
+bool BandDecomposition::reapBands() noexcept
+{
+	bool clean = true;
+#ifndef _WIN32
+	//closed first, so a band blocked writing its result gets an error instead of waiting on us
+	for (int band = 1; band < int(_resultPipes.size()); band++) {
+		if (_resultPipes[band] >= 0) close(_resultPipes[band]);
+		_resultPipes[band] = -1;
+	}
+
+	for (int band = 1; band < int(_processes.size()); band++) {
+		if (_processes[band] == 0) continue;
+		int status;
+		if (waitpid(_processes[band], &status, 0) != _processes[band] || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+			clean = false;
+		}
+		_processes[band] = 0;
+	}
+#endif
+	return clean;
+}
+
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,97 @@
+#pragma once
+#include "globals.h"
+#include "checkpoint.h"
+#include "tile-coloring.h"
+#include <functional>
+
+namespace pleistocene {
+namespace simulation {
+
+//Splits the world's rows into latitude bands, each simulated by its own process (forked from the one that built the world).
+//An hour is a sequence of phases: each tile-local step, and each color class of a step that writes neighbors (see TileColoring).
+//Within a phase every tile has at most one writer, so after each phase a band publishes the tiles it wrote that another band
+//touches (its halo: tiles adjacent to that band), and reads the ones other bands wrote. The arithmetic is that of the
+//single-process colored sweep, so results are bit-identical to World::simulate with _parallelSimulation.
+//Tile state crosses through shared memory (POSIX only).
+class BandDecomposition {
+public:
+	//phase of a step without neighbor writes. color classes are phases 0..colorCount-1
+	static const int kLocalPhase = -1;
+
+	typedef std::function<void(int tile, my::SnapshotWriter &writer)> TileWriter;
+	typedef std::function<void(int tile, my::SnapshotReader &reader)> TileReader;
+
+	//bands of about equal row count over the current my::Address grid. coloring must be built over graph
+	BandDecomposition(int bandCount, const TileColoring &coloring, const NeighborGraph &graph) noexcept;
+	~BandDecomposition() noexcept;
+
+	BandDecomposition(const BandDecomposition &) = delete;
+	BandDecomposition &operator=(const BandDecomposition &) = delete;
+
+	//maps the exchange buffers (sized from the largest halo tile state, see stateSize) and forks one process per band after the first.
+	//this process keeps band 0. false (and LOG) if nothing could be started
+	bool start(const std::function<size_t(int tile)> &stateSize) noexcept;
+
+	int getBand() const noexcept;
+	//tiles this process simulates, all of them or those of one color class
+	const std::vector<int> &getOwnTiles() const noexcept;
+	const std::vector<int> &getOwnTiles(int color) const noexcept;
+	//own tiles and their neighbors: everything this band's kernels read or write
+	const std::vector<int> &getTouchedTiles() const noexcept;
+
+	//after a phase: publish the halo tiles this band wrote, wait for every band, read the ones the others wrote
+	void exchange(int phase, const TileWriter &write, const TileReader &read) noexcept;
+
+	//brings every band's own tiles back into this process. the other processes exit here.
+	//false (and LOG) if a band failed
+	bool finish(const TileWriter &write, const TileReader &read) noexcept;
+
+private:
+	struct PhasePlan {
+		std::vector<int> _sends;
+		std::vector<int> _receives;
+	};
+
+	struct SharedState;
+
+	int _bandCount;
+	int _band = 0;
+	int _colorCount;
+
+	std::vector<std::vector<int>> _ownTiles;//by band
+	std::vector<std::vector<std::vector<int>>> _ownTilesByColor;//by band, color
+	std::vector<std::vector<int>> _touchedTiles;//by band
+	std::vector<std::vector<int>> _bandsTouching;//by tile
+	std::vector<std::vector<int>> _phaseWriters;//by phase + 1, tile. kFakeIndex if nothing writes the tile
+	std::vector<PhasePlan> _plans;//this band's, by phase + 1
+
+	std::vector<int> _slotOf;//exchange slot of each tile, kFakeIndex if no band ever sends it
+	int _slotCount = 0;
+	size_t _slotCapacity = 0;
+
+	//shared mapping: SharedState, slot sizes and slot data, two banks so one barrier per phase suffices
+	char *_shared = nullptr;
+	size_t _sharedSize = 0;
+	int _exchangeCount = 0;
+	my::SnapshotWriter _writer;
+
+	int _firstProcess = 0;//pid of band 0
+	std::vector<int> _processes;//pid of each band, 0 for this one
+	std::vector<int> _resultPipes;//read end in band 0, write end in the band itself
+
+	void planPhases() noexcept;
+
+	SharedState &sharedState() noexcept;
+	uint64_t &slotSize(int bank, int slot) noexcept;
+	char *slotData(int bank, int slot) noexcept;
+
+	//every band arrives before any leaves. a band that died or failed ends the run for all
+	void barrier() noexcept;
+	void fail() noexcept;
+	void checkPeers() noexcept;
+	//closes the result pipes and waits for the other bands. false if any failed
+	bool reapBands() noexcept;
+};
+
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,420 @@
+//pleistocene-bench: per-step cost of the climate simulation
+//builds a flat synthetic world of a given size and land fraction, drives every tile's MaterialColumn one step at a time
+//(the serial reference order, so the run matches World::simulate in serial mode) and times each step in ns per tile-hour.
+//also times the mixture kernels the steps lean on, and the batched radiation kernels against Mixture::emitInfrared
+//(with their largest relative deviation from it). results go out as JSON
+
+#include "globals.h"
+#include "game-options.h"
+#include "world.h"
+#include "state-mixture.h"
+#include "radiation-kernels.h"
+#include <chrono>
+#include <functional>
+
+namespace {
+
+using namespace pleistocene;
+using namespace pleistocene::simulation::climate;
+
+typedef std::chrono::steady_clock Clock;
+
+void printUsage() noexcept
+{
+	std::cerr <<
+		"usage: pleistocene-bench [options]\n"
+		"  --rows <n>      world rows (default 71)\n"
+		"  --cols <n>      world columns (default 60)\n"
+		"  --land <f>      fraction of land tiles, 0-1 (default 0.3)\n"
+		"  --seed <n>      land/sea layout seed (default 32360)\n"
+		"  --warmup <n>    untimed hours before measuring (default 24)\n"
+		"  --hours <n>     timed hours per repeat (default 24)\n"
+		"  --repeats <n>   repeats; median, min and max are reported (default 5)\n"
+		"  --calls <n>     calls per repeat for the mixture kernels (default 200000)\n"
+		"  --json <file>   write results to a file instead of stdout\n";
+}
+
+struct Result {
+	std::string name;
+	std::string unit;
+	std::vector<double> samples;
+};
+
+double seconds(Clock::time_point start, Clock::time_point end) noexcept
+{
+	return std::chrono::duration<double>(end - start).count();
+}
+
+//one timed sweep of a column function over every tile
+class StepTimer {
+public:
+	StepTimer(const std::vector<TileClimate*> &climates) noexcept :
+	_climates(climates)
+	{}
+
+	void sweep(int step, const std::function<void(TileClimate&)> &task) noexcept
+	{
+		auto start = Clock::now();
+		for (TileClimate *climate : _climates) {
+			task(*climate);
+		}
+		_seconds[step] += seconds(start, Clock::now());
+	}
+
+	std::map<int, double> _seconds;
+
+private:
+	const std::vector<TileClimate*> &_climates;
+};
+
+enum BenchStep {
+	BEGIN_HOUR,
+	SOLAR,
+	INFRARED,
+	CONDUCTION,
+	PRESSURE,
+	AIR_FLOW
+};
+
+const std::vector<std::pair<BenchStep, std::string>> kStepNames{
+	{ BEGIN_HOUR, "step.begin_new_hour" },
+	{ SOLAR, "step.filter_solar_radiation" },
+	{ INFRARED, "step.simulate_infrared_radiation" },
+	{ CONDUCTION, "step.simulate_conduction" },
+	{ PRESSURE, "step.simulate_pressure" },
+	{ AIR_FLOW, "step.simulate_air_flow" }
+};
+
+//one simulated hour, step by step in World::simulate's serial order. the tile-local parts of step 1 are split
+//into separate sweeps, which doesn't change the result since no tile reads another's state during step 1
+void simulateHour(const std::vector<TileClimate*> &climates, StepTimer &timer) noexcept
+{
+	my::SimulationTime::updateGlobalTime();
+	TileClimate::beginNewHour();
+
+	timer.sweep(BEGIN_HOUR, [](TileClimate &climate) { climate.getMaterialColumn().beginNewHour(); });
+	timer.sweep(SOLAR, [](TileClimate &climate) {
+		double energy = climate.simulateSolarRadiation();
+		if (energy > 0) { climate.getMaterialColumn().filterSolarRadiation(energy); }
+	});
+	timer.sweep(INFRARED, [](TileClimate &climate) { climate.getMaterialColumn().simulateInfraredRadiation(); });
+	timer.sweep(CONDUCTION, [](TileClimate &climate) { climate.getMaterialColumn().simulateConduction(); });
+	timer.sweep(PRESSURE, [](TileClimate &climate) { climate.getMaterialColumn().simulatePressure(); });
+	timer.sweep(AIR_FLOW, [](TileClimate &climate) { climate.getMaterialColumn().simulateAirFlow(); });
+}
+
+//ns per call of a kernel that is run back and forth so the mixtures keep their size
+double timeKernel(int calls, const std::function<void(int)> &kernel) noexcept
+{
+	auto start = Clock::now();
+	for (int i = 0; i < calls; i++) {
+		kernel(i);
+	}
+	return seconds(start, Clock::now()) * 1e9 / calls;
+}
+
+//layers to emit through RadiationKernels, and the same as Mixtures
+struct EmissionCase {
+	std::vector<double> temperature;
+	std::vector<double> infraredInput;
+	std::vector<double> infraredInputDisplay;
+	std::vector<double> outputRadiation;
+	std::vector<double> equilibriumTemperature;
+	std::vector<double> solarInput;
+	std::vector<double> heatCapacity;
+	std::vector<double> albedo;
+	std::vector<double> solarAbsorptionIndex;
+	std::vector<double> emissionPerT4;
+	std::vector<double> infraredAbsorptionIndex;
+	std::vector<double> emittor;
+	std::vector<double> emitted;
+
+	//layers cycle through the column's, spread over 200-350 K, absorbing 0.5-1.5 times what they emit
+	EmissionCase(const std::vector<layers::MaterialLayer*> &column, int count, std::vector<layers::elements::Mixture> &mixtures) noexcept
+	{
+		for (int i = 0; i < count; i++) {
+			layers::elements::Mixture mixture = *column[i % column.size()]->getMixture();
+			layers::elements::ThermalState state = mixture.getThermalState();
+
+			double spread = fmod(i * 0.618033988749895, 1.0);
+			state.temperature = 200 + 150 * spread;
+			state.hourlySolarInput = 0;
+			state.hourlyInfraredInput = (0.5 + fmod(spread * 7, 1.0)) * layers::elements::Mixture::calculateEmissions(state.gas, state.mass, state.temperature);
+			mixture.setThermalState(state);
+			mixtures.push_back(mixture);
+
+			temperature.push_back(state.temperature);
+			infraredInput.push_back(state.hourlyInfraredInput);
+			infraredInputDisplay.push_back(state.hourlyInfraredInputDisplay);
+			solarInput.push_back(state.hourlySolarInput);
+			heatCapacity.push_back(state.heatCapacity);
+			albedo.push_back(state.albedo);
+			solarAbsorptionIndex.push_back(state.solarAbsorptionIndex);
+			emissionPerT4.push_back(layers::elements::Mixture::calculateEmissions(state.gas, state.mass, 1.0));
+			infraredAbsorptionIndex.push_back(state.infraredAbsorptionIndex);
+			emittor.push_back(state.emittor ? 1 : 0);
+		}
+		outputRadiation.assign(count, 0);
+		equilibriumTemperature.assign(count, 0);
+		emitted.assign(count, 0);
+	}
+
+	RadiationBatch batch() noexcept
+	{
+		RadiationBatch batch;
+		batch.temperature = temperature.data();
+		batch.infraredInput = infraredInput.data();
+		batch.infraredInputDisplay = infraredInputDisplay.data();
+		batch.outputRadiation = outputRadiation.data();
+		batch.equilibriumTemperature = equilibriumTemperature.data();
+		batch.solarInput = solarInput.data();
+		batch.heatCapacity = heatCapacity.data();
+		batch.albedo = albedo.data();
+		batch.solarAbsorptionIndex = solarAbsorptionIndex.data();
+		batch.emissionPerT4 = emissionPerT4.data();
+		batch.infraredAbsorptionIndex = infraredAbsorptionIndex.data();
+		batch.emittor = emittor.data();
+		batch.count = int(temperature.size());
+		return batch;
+	}
+};
+
+double relativeError(double value, double reference) noexcept
+{
+	if (reference == 0) return abs(value);
+	return abs(value - reference) / abs(reference);
+}
+
+double median(std::vector<double> values) noexcept
+{
+	std::sort(values.begin(), values.end());
+	size_t middle = values.size() / 2;
+	if (values.size() % 2) return values[middle];
+	return (values[middle - 1] + values[middle]) / 2;
+}
+
+void writeJson(std::ostream &out, const std::map<std::string, std::string> &config, const std::vector<Result> &results) noexcept
+{
+	out << "{\n  \"benchmark\": \"pleistocene-bench\",\n  \"config\": {";
+	bool first = true;
+	for (auto &entry : config) {
+		out << (first ? "\n" : ",\n") << "    \"" << entry.first << "\": " << entry.second;
+		first = false;
+	}
+	out << "\n  },\n  \"results\": [";
+
+	first = true;
+	for (const Result &result : results) {
+		out << (first ? "\n" : ",\n") << "    { \"name\": \"" << result.name << "\", \"unit\": \"" << result.unit << "\""
+			<< ", \"median\": " << median(result.samples)
+			<< ", \"min\": " << *std::min_element(result.samples.begin(), result.samples.end())
+			<< ", \"max\": " << *std::max_element(result.samples.begin(), result.samples.end())
+			<< ", \"samples\": [";
+		for (size_t i = 0; i < result.samples.size(); i++) {
+			out << (i ? ", " : "") << result.samples[i];
+		}
+		out << "] }";
+		first = false;
+	}
+	out << "\n  ]\n}\n";
+}
+
+}//namespace
+
+int main(int argc, char* args[]) noexcept
+{
+	using namespace pleistocene;
+	using namespace pleistocene::simulation::climate;
+
+	options::GameOptions options;
+	int rows = 71;
+	int cols = 60;
+	double landFraction = 0.3;
+	int warmup = 24;
+	int hours = 24;
+	int repeats = 5;
+	int calls = 200000;
+	std::string jsonPath;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = args[i];
+		bool hasValue = (i + 1 < argc);
+
+		if (arg == "--rows" && hasValue) { rows = std::max(3, atoi(args[++i])); }
+		else if (arg == "--cols" && hasValue) { cols = std::max(3, atoi(args[++i])); }
+		else if (arg == "--land" && hasValue) { landFraction = atof(args[++i]); }
+		else if (arg == "--seed" && hasValue) { options._worldSeed = atof(args[++i]); }
+		else if (arg == "--warmup" && hasValue) { warmup = std::max(0, atoi(args[++i])); }
+		else if (arg == "--hours" && hasValue) { hours = std::max(1, atoi(args[++i])); }
+		else if (arg == "--repeats" && hasValue) { repeats = std::max(1, atoi(args[++i])); }
+		else if (arg == "--calls" && hasValue) { calls = std::max(1, atoi(args[++i])); }
+		else if (arg == "--json" && hasValue) { jsonPath = args[++i]; }
+		else { printUsage(); return EXIT_FAILURE; }
+	}
+
+	options.setWorldDimensions(rows, cols);
+	options._parallelSimulation = false;
+
+	simulation::World world(options);
+	world.generateSyntheticWorld(landFraction);
+
+	std::vector<TileClimate*> climates;
+	int landTiles = 0;
+	for (const simulation::Tile &tile : world.getTiles()) {
+		climates.push_back(const_cast<TileClimate*>(&tile._tileClimate));
+		if (tile._tileClimate.getMaterialColumn().getLandElevation() > 0) landTiles++;
+	}
+	double tileHours = double(climates.size()) * hours;
+
+	StepTimer warmupTimer(climates);
+	for (int hour = 0; hour < warmup; hour++) {
+		simulateHour(climates, warmupTimer);
+	}
+
+	//STEPS
+	//==================
+	std::vector<Result> results;
+	for (auto &step : kStepNames) {
+		results.push_back(Result{ step.second, "ns/tile-hour", {} });
+	}
+	results.push_back(Result{ "hour.total", "ns/tile-hour", {} });
+
+	for (int repeat = 0; repeat < repeats; repeat++) {
+		StepTimer timer(climates);
+		for (int hour = 0; hour < hours; hour++) {
+			simulateHour(climates, timer);
+		}
+
+		double total = 0;
+		for (size_t i = 0; i < kStepNames.size(); i++) {
+			double stepSeconds = timer._seconds[kStepNames[i].first];
+			results[i].samples.push_back(stepSeconds * 1e9 / tileHours);
+			total += stepSeconds;
+		}
+		results.back().samples.push_back(total * 1e9 / tileHours);
+	}
+
+	//MIXTURE KERNELS
+	//==================
+	//copies of a real column's mixtures, so composition matches what the steps move around
+	layers::MaterialColumn &column = climates.front()->getMaterialColumn();
+	std::vector<layers::MaterialLayer*> layerColumn = column.getColumn();
+
+	layers::AirLayer *airLayer = nullptr;
+	for (layers::MaterialLayer *layer : layerColumn) {
+		if (layer->getType() == layers::AIR) { airLayer = static_cast<layers::AirLayer*>(layer); break; }
+	}
+	layers::elements::GaseousMixture gasA = *airLayer->getGasPtr();
+	layers::elements::GaseousMixture gasB = *airLayer->getGasPtr();
+	layers::elements::Mixture mixtureA = *airLayer->getMixture();
+	layers::elements::Mixture mixtureB = *airLayer->getMixture();
+	layers::elements::Element element(layers::elements::MOLAR, layers::elements::DRY_AIR, 1000, layers::elements::GAS);
+
+	const double proportion = 0.01;
+
+	Result transferResult{ "kernel.mixture_transfer", "ns/call", {} };
+	Result airFlowResult{ "kernel.gaseous_air_flow", "ns/call", {} };
+	Result resizeResult{ "kernel.element_resize", "ns/call", {} };
+
+	for (int repeat = 0; repeat < repeats; repeat++) {
+		transferResult.samples.push_back(timeKernel(calls, [&](int i) {
+			if (i % 2) layers::elements::Mixture::transferMixture(mixtureA, mixtureB, proportion);
+			else layers::elements::Mixture::transferMixture(mixtureB, mixtureA, proportion);
+		}));
+		airFlowResult.samples.push_back(timeKernel(calls, [&](int i) {
+			if (i % 2) layers::elements::GaseousMixture::airFlow(gasA, gasB, proportion);
+			else layers::elements::GaseousMixture::airFlow(gasB, gasA, proportion);
+		}));
+		resizeResult.samples.push_back(timeKernel(calls, [&](int i) {
+			element.resizeBy(i % 2 ? 1.01 : 1 / 1.01);
+		}));
+	}
+
+	results.push_back(transferResult);
+	results.push_back(airFlowResult);
+	results.push_back(resizeResult);
+
+	//RADIATION KERNELS
+	//==================
+	const int kEmissionLayers = 4096;
+	std::vector<layers::elements::Mixture> emissionMixtures;
+	const EmissionCase emissionCase(layerColumn, kEmissionLayers, emissionMixtures);
+	int emissionRounds = std::max(1, calls / kEmissionLayers);
+
+	//what the batches are checked against
+	std::vector<layers::elements::Mixture> reference = emissionMixtures;
+	std::vector<double> referenceEmitted;
+	for (layers::elements::Mixture &mixture : reference) {
+		referenceEmitted.push_back(mixture.emitInfrared());
+	}
+
+	Result mixtureEmissionResult{ "kernel.mixture_emit_infrared", "ns/layer", {} };
+	for (int repeat = 0; repeat < repeats; repeat++) {
+		double total = 0;
+		for (int round = 0; round < emissionRounds; round++) {
+			std::vector<layers::elements::Mixture> working = emissionMixtures;
+			auto start = Clock::now();
+			for (layers::elements::Mixture &mixture : working) {
+				mixture.emitInfrared();
+			}
+			total += seconds(start, Clock::now());
+		}
+		mixtureEmissionResult.samples.push_back(total * 1e9 / (double(emissionRounds) * kEmissionLayers));
+	}
+	results.push_back(mixtureEmissionResult);
+
+	for (RadiationIsa isa : { SCALAR_RADIATION, AVX2_RADIATION, AVX512_RADIATION }) {
+		const RadiationKernels *kernels = radiationKernels(isa);
+		if (!kernels) continue;
+
+		std::string name = std::string("kernel.batch_emit_infrared.") + radiationIsaName(isa);
+		Result timeResult{ name, "ns/layer", {} };
+		Result errorResult{ name + ".max_relative_error", "ratio", {} };
+
+		for (int repeat = 0; repeat < repeats; repeat++) {
+			double total = 0;
+			double maxError = 0;
+			for (int round = 0; round < emissionRounds; round++) {
+				EmissionCase working = emissionCase;
+				RadiationBatch batch = working.batch();
+				auto start = Clock::now();
+				kernels->emitExplicit(batch, working.emitted.data());
+				total += seconds(start, Clock::now());
+
+				for (int i = 0; i < kEmissionLayers; i++) {
+					maxError = std::max(maxError, relativeError(working.emitted[i], referenceEmitted[i]));
+					maxError = std::max(maxError, relativeError(working.temperature[i], reference[i].getTemperature()));
+				}
+			}
+			timeResult.samples.push_back(total * 1e9 / (double(emissionRounds) * kEmissionLayers));
+			errorResult.samples.push_back(maxError);
+		}
+		results.push_back(timeResult);
+		results.push_back(errorResult);
+	}
+
+	std::map<std::string, std::string> config{
+		{ "rows", std::to_string(rows) },
+		{ "cols", std::to_string(cols) },
+		{ "tiles", std::to_string(climates.size()) },
+		{ "land_fraction", std::to_string(landFraction) },
+		{ "land_tiles", std::to_string(landTiles) },
+		{ "seed", std::to_string(options._worldSeed) },
+		{ "warmup_hours", std::to_string(warmup) },
+		{ "hours", std::to_string(hours) },
+		{ "repeats", std::to_string(repeats) },
+		{ "kernel_calls", std::to_string(calls) },
+		{ "radiation_isa", std::string("\"") + radiationIsaName(radiationKernels().isa) + "\"" }
+	};
+
+	if (jsonPath.empty()) {
+		writeJson(std::cout, config, results);
+	}
+	else {
+		std::ofstream file(jsonPath);
+		if (!file) { std::cerr << "could not open " << jsonPath << "\n"; return EXIT_FAILURE; }
+		writeJson(file, config, results);
+	}
+
+	return 0;
+}
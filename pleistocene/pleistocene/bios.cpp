@@ -4,6 +4,7 @@
 #include "tile.h"
 #include "world.h"
 #include "game-options.h"
+#include "profiler.h"
 
 namespace pleistocene {
 namespace user_interface {
@@ -19,6 +20,10 @@ Bios::Bios(graphics::Graphics &graphics) noexcept {
 
 void Bios::update(std::vector<std::string> messages) noexcept {
 	_messages = messages;
+	if (_showProfile) {
+		std::vector<std::string> profile = my::Profiler::getMessages();
+		_messages.insert(_messages.end(), profile.begin(), profile.end());
+	}
 	if (_messages.empty()) {
 		_display = false;
 	}
@@ -44,6 +49,8 @@ void Bios::draw(graphics::Graphics &graphics) noexcept {
 }
 
 
+void Bios::toggleProfile() noexcept { _showProfile = !_showProfile; }
+
 
 InfoBar::InfoBar() noexcept {}
 
@@ -55,8 +62,8 @@ InfoBar::InfoBar(graphics::Graphics &graphics) noexcept {
 
 
 
-void InfoBar::update(std::vector<std::string> messages) noexcept {
-	_timeReadout = my::SimulationTime::readGlobalTime();
+void InfoBar::update(std::vector<std::string> timeReadout, std::vector<std::string> messages) noexcept {
+	_timeReadout = timeReadout;
 	_worldReadout = messages;
 }
 
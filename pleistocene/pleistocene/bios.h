@@ -27,11 +27,15 @@ public:
 
 	void update(std::vector<std::string> messages) noexcept;
 	void draw(graphics::Graphics &graphics) noexcept;
+
+	//show section timings (my::Profiler) below the tile messages
+	void toggleProfile() noexcept;
 private:
 
 	bool _exists = false;
 
 	bool _display = false;
+	bool _showProfile = false;
 
 	std::vector<std::string> _messages;
 	SDL_Rect _displayRect;
@@ -45,7 +49,7 @@ public:
 	InfoBar(graphics::Graphics &graphics) noexcept;
 
 	void draw(graphics::Graphics &graphics) noexcept;
-	void update(std::vector<std::string> messages) noexcept;
+	void update(std::vector<std::string> timeReadout, std::vector<std::string> messages) noexcept;
 
 private:
 
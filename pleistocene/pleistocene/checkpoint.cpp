@@ -0,0 +1,173 @@
+#include "checkpoint.h"
+#include <cstdio>
+#include <cstddef>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pleistocene {
+namespace my {
+
+namespace {
+
+//magic, version, (reserved), payload bytes
+struct SnapshotHeader {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t payloadSize;
+};
+
+}//namespace
+
+//======================================
+//WRITER
+//======================================
+
+SnapshotWriter::SnapshotWriter() noexcept
+{
+	SnapshotHeader header{ kSnapshotMagic, kSnapshotVersion, 0, 0 };
+	write(header);
+}
+
+void SnapshotWriter::writeVector(const Eigen::Vector3d &vector) noexcept
+{
+	for (int i = 0; i < 3; i++) {
+		write(vector(i));
+	}
+}
+
+bool SnapshotWriter::saveToFile(const std::string &path) noexcept
+{
+	uint64_t payloadSize = _buffer.size() - sizeof(SnapshotHeader);
+	std::memcpy(_buffer.data() + offsetof(SnapshotHeader, payloadSize), &payloadSize, sizeof(payloadSize));
+
+	FILE *file = fopen(path.c_str(), "wb");
+	if (!file) { LOG("Could not open " << path << " for writing"); return false; }
+
+	size_t written = fwrite(_buffer.data(), 1, _buffer.size(), file);
+	bool closed = (fclose(file) == 0);
+
+	if (written != _buffer.size() || !closed) { LOG("Could not write snapshot " << path); return false; }
+	return true;
+}
+
+void SnapshotWriter::clear() noexcept { _buffer.clear(); }
+
+const char *SnapshotWriter::data() const noexcept { return _buffer.data(); }
+
+size_t SnapshotWriter::size() const noexcept { return _buffer.size(); }
+
+//======================================
+//READER
+//======================================
+
+SnapshotReader::SnapshotReader() noexcept {}
+
+SnapshotReader::~SnapshotReader() noexcept { close(); }
+
+bool SnapshotReader::open(const std::string &path) noexcept
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) { LOG("Could not open snapshot " << path); return false; }
+	_file = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < LONGLONG(sizeof(SnapshotHeader))) {
+		LOG("Not a snapshot: " << path); close(); return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) { LOG("Could not map snapshot " << path); close(); return false; }
+	_mapping = mapping;
+
+	_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!_data) { LOG("Could not map snapshot " << path); close(); return false; }
+	_size = size_t(fileSize.QuadPart);
+	_mapped = true;
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) { LOG("Could not open snapshot " << path); return false; }
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || size_t(fileStat.st_size) < sizeof(SnapshotHeader)) {
+		LOG("Not a snapshot: " << path); ::close(file); return false;
+	}
+
+	void *data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);//the mapping keeps the file alive
+	if (data == MAP_FAILED) { LOG("Could not map snapshot " << path); return false; }
+
+	_data = static_cast<const char*>(data);
+	_size = size_t(fileStat.st_size);
+	_mapped = true;
+#endif
+
+	SnapshotHeader header;
+	read(header);
+
+	if (header.magic != kSnapshotMagic) { LOG("Not a snapshot: " << path); close(); return false; }
+	if (header.version != kSnapshotVersion) {
+		LOG("Snapshot " << path << " is version " << header.version << ", expected " << kSnapshotVersion); close(); return false;
+	}
+	if (header.payloadSize != _size - sizeof(SnapshotHeader)) { LOG("Truncated snapshot " << path); close(); return false; }
+
+	return true;
+}
+
+void SnapshotReader::openBuffer(const char *data, size_t size) noexcept
+{
+	close();
+	_data = data;
+	_size = size;
+}
+
+void SnapshotReader::close() noexcept
+{
+#ifdef _WIN32
+	if (_mapped) UnmapViewOfFile(_data);
+	if (_mapping) CloseHandle(_mapping);
+	if (_file) CloseHandle(_file);
+	_mapping = nullptr;
+	_file = nullptr;
+#else
+	if (_mapped) munmap(const_cast<char*>(_data), _size);
+#endif
+	_mapped = false;
+	_data = nullptr;
+	_size = 0;
+	_position = 0;
+}
+
+void SnapshotReader::readVector(Eigen::Vector3d &vector) noexcept
+{
+	for (int i = 0; i < 3; i++) {
+		read(vector(i));
+	}
+}
+
+void SnapshotReader::expect(uint32_t tag) noexcept
+{
+	if (read<uint32_t>() != tag) { LOG("Corrupt snapshot (section tag mismatch)"); exit(EXIT_FAILURE); }
+}
+
+bool SnapshotReader::atEnd() const noexcept { return _position == _size; }
+
+void SnapshotReader::require(size_t bytes) const noexcept
+{
+	if (!_data || _position + bytes > _size) { LOG("Corrupt snapshot (read past end)"); exit(EXIT_FAILURE); }
+}
+
+}//namespace my
+}//namespace pleistocene
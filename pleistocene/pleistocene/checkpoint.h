@@ -0,0 +1,102 @@
+#pragma once
+#include "globals.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pleistocene {
+namespace my {
+
+//Binary world snapshots (see World::saveSnapshot/loadSnapshot).
+//Values are stored raw in native byte order, so a snapshot is only meant to be read back on the machine/build that wrote it.
+//Bump kSnapshotVersion whenever any writeSnapshot/readSnapshot pair changes.
+const uint64_t kSnapshotMagic = 0x50414E5354534C50ull;//"PLSTSNAP"
+const uint32_t kSnapshotVersion = 1;
+
+//section tags, checked on load to catch a reader/writer mismatch early
+const uint32_t kSnapshotTilesTag = 0x53454C54;//"TLES"
+const uint32_t kSnapshotSurfacesTag = 0x46525553;//"SURF"
+
+//Builds the whole snapshot in memory so it goes to disk in one sequential write
+class SnapshotWriter {
+public:
+	SnapshotWriter() noexcept;//writes the header
+
+	template<typename T>
+	void write(const T &value) noexcept
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+		size_t position = _buffer.size();
+		_buffer.resize(position + sizeof(T));
+		std::memcpy(_buffer.data() + position, &value, sizeof(T));
+	}
+
+	void writeVector(const Eigen::Vector3d &vector) noexcept;
+
+	//fills in the payload size and writes the file. false (and LOG) on failure
+	bool saveToFile(const std::string &path) noexcept;
+
+	//drops everything, header included, to reuse the writer as a plain buffer (see SnapshotReader::openBuffer)
+	void clear() noexcept;
+	const char *data() const noexcept;
+	size_t size() const noexcept;
+
+private:
+	std::vector<char> _buffer;
+};
+
+//Reads a snapshot straight out of a memory mapped file
+class SnapshotReader {
+public:
+	SnapshotReader() noexcept;
+	~SnapshotReader() noexcept;
+
+	SnapshotReader(const SnapshotReader &) = delete;
+	SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+	//maps the file and checks the header. false (and LOG) if it is missing, truncated or from another version
+	bool open(const std::string &path) noexcept;
+	//reads a headerless buffer (see SnapshotWriter::clear), which the caller keeps alive
+	void openBuffer(const char *data, size_t size) noexcept;
+
+	template<typename T>
+	void read(T &value) noexcept
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+		require(sizeof(T));
+		std::memcpy(&value, _data + _position, sizeof(T));
+		_position += sizeof(T);
+	}
+
+	template<typename T>
+	T read() noexcept
+	{
+		T value;
+		read(value);
+		return value;
+	}
+
+	void readVector(Eigen::Vector3d &vector) noexcept;
+
+	//section tag check. a mismatch means the snapshot is corrupt
+	void expect(uint32_t tag) noexcept;
+
+	bool atEnd() const noexcept;
+
+private:
+	void require(size_t bytes) const noexcept;
+	void close() noexcept;
+
+	const char *_data = nullptr;
+	size_t _size = 0;
+	size_t _position = 0;
+	bool _mapped = false;//_data is our file mapping, not a caller's buffer
+
+#ifdef _WIN32
+	void *_file = nullptr;
+	void *_mapping = nullptr;
+#endif
+};
+
+}//namespace my
+}//namespace pleistocene
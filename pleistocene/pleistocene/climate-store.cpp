@@ -0,0 +1,548 @@
+#include "climate-store.h"
+#include "radiative-transfer.h"
+#include "shared-surface.h"
+#include "tile-climate.h"
+#include "worker-pool.h"
+#include <unordered_map>
+#include <unordered_map>
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+using layers::elements::Mixture;
+using layers::elements::ThermalState;
+
+//======================================
+//LAYER ARRAYS
+//======================================
+
+int LayerArrays::add(Mixture *mixture) noexcept
+{
+	mixtures.push_back(mixture);
+	return int(mixtures.size()) - 1;
+}
+
+void LayerArrays::resizeFields() noexcept
+{
+	int n = int(mixtures.size());
+	for (std::vector<double> *field : { &temperature, &heatCapacity, &mass, &mols, &albedo,
+		&solarAbsorptionIndex, &infraredAbsorptionIndex, &inertiaX, &inertiaY, &inertiaZ,
+		&hourlySolarInput, &hourlyInfraredInput, &hourlyInfraredInputDisplay, &hourlyOutputRadiation,
+		&netConductiveExchange, &equilibriumTemperature }) {
+		field->resize(n);
+	}
+	emittor.resize(n);
+	gas.resize(n);
+}
+
+void LayerArrays::clear() noexcept
+{
+	for (std::vector<double> *field : { &temperature, &heatCapacity, &mass, &mols, &albedo,
+		&solarAbsorptionIndex, &infraredAbsorptionIndex, &inertiaX, &inertiaY, &inertiaZ,
+		&hourlySolarInput, &hourlyInfraredInput, &hourlyInfraredInputDisplay, &hourlyOutputRadiation,
+		&netConductiveExchange, &equilibriumTemperature }) {
+		field->clear();
+	}
+	emittor.clear();
+	gas.clear();
+	mixtures.clear();
+}
+
+int LayerArrays::size() const noexcept { return int(mixtures.size()); }
+
+void LayerArrays::gather(int i) noexcept
+{
+	ThermalState state = mixtures[i]->getThermalState();
+
+	temperature[i] = state.temperature;
+	heatCapacity[i] = state.heatCapacity;
+	mass[i] = state.mass;
+	mols[i] = state.mols;
+	albedo[i] = state.albedo;
+	solarAbsorptionIndex[i] = state.solarAbsorptionIndex;
+	infraredAbsorptionIndex[i] = state.infraredAbsorptionIndex;
+	inertiaX[i] = state.inertia[0];
+	inertiaY[i] = state.inertia[1];
+	inertiaZ[i] = state.inertia[2];
+
+	hourlySolarInput[i] = state.hourlySolarInput;
+	hourlyInfraredInput[i] = state.hourlyInfraredInput;
+	hourlyInfraredInputDisplay[i] = state.hourlyInfraredInputDisplay;
+	hourlyOutputRadiation[i] = state.hourlyOutputRadiation;
+	netConductiveExchange[i] = state.netConductiveExchange;
+	equilibriumTemperature[i] = state.equilibriumTemperature;
+
+	emittor[i] = state.emittor;
+	gas[i] = state.gas;
+}
+
+void LayerArrays::scatter(int i) const noexcept
+{
+	ThermalState state;
+
+	state.temperature = temperature[i];
+	state.hourlySolarInput = hourlySolarInput[i];
+	state.hourlyInfraredInput = hourlyInfraredInput[i];
+	state.hourlyInfraredInputDisplay = hourlyInfraredInputDisplay[i];
+	state.hourlyOutputRadiation = hourlyOutputRadiation[i];
+	state.netConductiveExchange = netConductiveExchange[i];
+	state.equilibriumTemperature = equilibriumTemperature[i];
+
+	mixtures[i]->setThermalState(state);
+}
+
+//======================================
+//INITIALIZATION
+//======================================
+
+ClimateStore::ClimateStore() noexcept : _radiativeTransfer(new RadiativeTransfer()) {}
+
+ClimateStore::~ClimateStore() noexcept {}
+
+ClimateStore::ClimateStore(ClimateStore &&other) noexcept = default;
+
+ClimateStore &ClimateStore::operator=(ClimateStore &&other) noexcept = default;
+
+namespace {
+void forEachTileRange(my::WorkerPool *pool, int tileCount, const std::function<void(int, int)> &task) noexcept
+{
+	if (pool) { pool->run(tileCount, task); }
+	else { task(0, tileCount); }
+}
+}
+
+void ClimateStore::build(const std::vector<layers::MaterialColumn*> &columns, my::WorkerPool *pool) noexcept
+{
+	for (LayerArrays &layerArrays : _layers) layerArrays.clear();
+
+	_columns = columns;
+	int tileCount = int(_columns.size());
+
+	_columnOffsets.assign(1, 0);
+	_columnSlots.clear();
+	_surfaceSlots.assign(tileCount, LayerSlot());
+	_airBegin.assign(tileCount, 0);
+	_airEnd.assign(tileCount, 0);
+	_backRadiation.assign(tileCount, 0);
+	_escapeRadiation.assign(tileCount, 0);
+
+	//looked up once per surface, hence hashed
+	std::unordered_map<const layers::MaterialLayer*, LayerSlot> slots;
+	size_t layerCount = 0;
+	for (layers::MaterialColumn *column : _columns) layerCount += column->getColumn().size();
+	slots.reserve(layerCount);
+	_columnSlots.reserve(layerCount);
+
+	//layer slots, column by column so each tile's air layers are contiguous
+	for (int tile = 0; tile < tileCount; tile++) {
+		const std::vector<layers::MaterialLayer*> &column = _columns[tile]->getColumn();
+
+		for (layers::MaterialLayer *layer : column) {
+			LayerSlot slot;
+			slot.type = layer->getType();
+			slot.index = _layers[slot.type].add(layer->getMixture());
+
+			if (slot.type == layers::AIR) {
+				if (_airEnd[tile] == 0) _airBegin[tile] = slot.index;
+				_airEnd[tile] = slot.index + 1;
+			}
+
+			_columnSlots.push_back(slot);
+			slots[layer] = slot;
+		}
+		_columnOffsets.push_back(int(_columnSlots.size()));
+
+		if (_airEnd[tile] - _airBegin[tile] > layers::air::kMaxAirLayers) { LOG("Too many air layers"); exit(EXIT_FAILURE); }
+	}
+
+	for (LayerArrays &layerArrays : _layers) layerArrays.resizeFields();
+
+	forEachTileRange(pool, tileCount, [this](int begin, int end) {
+		for (int tile = begin; tile < end; tile++) gatherTile(tile);
+	});
+
+	for (int tile = 0; tile < tileCount; tile++) {
+		_surfaceSlots[tile] = slots[_columns[tile]->getSurfaceLayer()];
+	}
+
+	_radiativeTransfer->build(_columnOffsets, _columnSlots, _surfaceSlots, _airBegin, _airEnd);
+
+	//conduction pairs in MaterialColumn::simulateConduction order (tenants may be in neighboring columns).
+	//counted first, so each tile fills its own stretch
+	_pairOffsets.assign(1, 0);
+	_sidePairOffsets.assign(1, 0);
+
+	_verticalLevels = 0;
+	for (int tile = 0; tile < tileCount; tile++) {
+		_verticalLevels = std::max(_verticalLevels, _columnOffsets[tile + 1] - _columnOffsets[tile]);
+
+		int pairs = 0;
+		int sidePairs = 0;
+		for (layers::MaterialLayer *layer : _columns[tile]->getColumn()) {
+			for (layers::SharedSurface &surface : layer->getSharedSurfaces()) {
+				pairs++;
+				if (surface._spatialDirection != layers::UP) sidePairs++;
+			}
+		}
+		_pairOffsets.push_back(_pairOffsets.back() + pairs);
+		_sidePairOffsets.push_back(_sidePairOffsets.back() + sidePairs);
+	}
+
+	_conductionPairs.assign(_pairOffsets.back(), ConductionPair());
+	_sidePairs.assign(_sidePairOffsets.back(), ConductionPair());
+
+	LayerSlot padding;
+	padding.type = layers::EARTH;
+	padding.index = my::kFakeIndex;
+	_verticalSlots.assign(_verticalLevels*tileCount, padding);
+	_verticalConductance.assign((_verticalLevels + 1)*tileCount, 0);
+	_verticalCapacity.assign(_verticalLevels*tileCount, 1);
+	_verticalTemperature.assign(_verticalLevels*tileCount, 0);
+	_verticalSolution.assign((_verticalLevels + 1)*tileCount, 0);
+	_verticalCPrime.assign((_verticalLevels + 1)*tileCount, 0);
+	_verticalDPrime.assign((_verticalLevels + 1)*tileCount, 0);
+
+	forEachTileRange(pool, tileCount, [this, tileCount, &slots](int begin, int end) {
+		for (int tile = begin; tile < end; tile++) {
+			const std::vector<layers::MaterialLayer*> &column = _columns[tile]->getColumn();
+			int pair = _pairOffsets[tile];
+			int sidePair = _sidePairOffsets[tile];
+
+			for (int level = 0; level < int(column.size()); level++) {
+				_verticalSlots[level*tileCount + tile] = _columnSlots[_columnOffsets[tile] + level];
+
+				for (layers::SharedSurface &surface : column[level]->getSharedSurfaces()) {
+					if (surface.getArea() < 0) { LOG("Negative Area");  exit(EXIT_FAILURE); }
+
+					ConductionPair &conductionPair = _conductionPairs[pair++];
+					conductionPair.tenant = slots.at(surface.getTenant());
+					conductionPair.owner = slots.at(surface.getOwner());
+					conductionPair.area = surface.getArea();
+					conductionPair.conductivity = Mixture::conductivity(*surface.getTenant()->getMixture(), *surface.getOwner()->getMixture());
+
+					if (surface._spatialDirection != layers::UP) {
+						_sidePairs[sidePair++] = conductionPair;
+						continue;
+					}
+					if (level + 1 == int(column.size()) || surface.getTenant() != column[level + 1]) {
+						LOG("Top surface not shared with the layer above"); exit(EXIT_FAILURE);
+					}
+					_verticalConductance[(level + 1)*tileCount + tile] = conductionPair.conductivity*conductionPair.area;
+				}
+			}
+		}
+	});
+}
+
+bool ClimateStore::isBuilt() const noexcept { return !_columns.empty(); }
+
+int ClimateStore::getTileCount() const noexcept { return int(_columns.size()); }
+
+bool ClimateStore::handlesStep(int simulationStep) noexcept { return (simulationStep == 1 || simulationStep == 2); }
+
+bool ClimateStore::gathersBefore(int simulationStep) noexcept { return (simulationStep == 1); }
+
+bool ClimateStore::scattersAfter(int simulationStep) noexcept { return (simulationStep == 2); }
+
+LayerArrays &ClimateStore::arrays(LayerSlot slot) noexcept { return _layers[slot.type]; }
+
+void ClimateStore::gatherTile(int tile) noexcept
+{
+	for (int k = _columnOffsets[tile]; k < _columnOffsets[tile + 1]; k++) {
+		arrays(_columnSlots[k]).gather(_columnSlots[k].index);
+	}
+}
+
+void ClimateStore::scatterTile(int tile) noexcept
+{
+	for (int k = _columnOffsets[tile]; k < _columnOffsets[tile + 1]; k++) {
+		arrays(_columnSlots[k]).scatter(_columnSlots[k].index);
+	}
+	_columns[tile]->setRadiationBudget(_backRadiation[tile], _escapeRadiation[tile]);
+}
+
+//======================================
+//SIMULATION
+//======================================
+
+void ClimateStore::beginNewHour(int tile) noexcept
+{
+	_backRadiation[tile] = 0;
+	_escapeRadiation[tile] = 0;
+
+	for (int k = _columnOffsets[tile]; k < _columnOffsets[tile + 1]; k++) {
+		LayerArrays &layer = arrays(_columnSlots[k]);
+		int i = _columnSlots[k].index;
+
+		layer.hourlySolarInput[i] = 0;
+		layer.hourlyInfraredInputDisplay[i] = 0;
+		layer.hourlyOutputRadiation[i] = 0;
+		layer.netConductiveExchange[i] = 0;
+	}
+}
+
+//MaterialLayer::filterSolarRadiation, top of the column downward
+void ClimateStore::filterSolarRadiation(int tile, double energyKJ) noexcept
+{
+	int bottom = _columnOffsets[tile];
+	int top = _columnOffsets[tile + 1] - 1;
+
+	for (int k = top; k >= bottom; k--) {
+		if (k == top) {//stratosphere
+			energyKJ = filterSolar(_columnSlots[k], 3 * energyKJ) / 3;
+		}
+		else {
+			energyKJ = filterSolar(_columnSlots[k], energyKJ);
+		}
+
+		//don't send down less than a joule
+		if (energyKJ <= 0.001) break;
+
+		if (k == bottom) { LOG("Sun to bedrock?"); exit(EXIT_FAILURE); }
+	}
+}
+
+//MaterialColumn::simulateInfraredRadiation
+void ClimateStore::simulateInfraredRadiation(int tile) noexcept
+{
+	LayerSlot surface = _surfaceSlots[tile];
+	LayerSlot air = { layers::AIR, 0 };
+
+	double downRadiation[layers::air::kMaxAirLayers];//radiation incident downwards upon layer
+	int airLayers = _airEnd[tile] - _airBegin[tile];
+
+	double upRadiation = emitInfrared(surface);
+	double emittedEnergy;
+
+	//filter/emit upwards
+	for (int j = 0; j < airLayers; j++) {
+		air.index = _airBegin[tile] + j;
+		upRadiation = filterInfrared(air, upRadiation);
+		emittedEnergy = emitInfrared(air);
+		downRadiation[j] = emittedEnergy / 2.0;
+		upRadiation += emittedEnergy / 2.0;
+	}
+	_escapeRadiation[tile] = upRadiation;
+
+	//filter downwards
+	for (int j = airLayers - 2; j >= 0; j--) {
+		air.index = _airBegin[tile] + j;
+		downRadiation[j] += filterInfrared(air, downRadiation[j + 1]);
+	}
+
+	_backRadiation[tile] = downRadiation[0];
+
+	filterInfrared(surface, downRadiation[0]);
+}
+
+void ClimateStore::setBatchedRadiation(bool batched) noexcept { _batchedRadiation = batched; }
+
+bool ClimateStore::batchesRadiationAfter(int simulationStep) const noexcept
+{
+	return (_batchedRadiation && simulationStep == 1);
+}
+
+void ClimateStore::setSolarEnergy(int tile, double energyKJ) noexcept { _radiativeTransfer->setSolarEnergy(tile, energyKJ); }
+
+void ClimateStore::simulateRadiation(int beginTile, int endTile) noexcept
+{
+	_radiativeTransfer->simulate(_layers, beginTile, endTile, _backRadiation, _escapeRadiation);
+}
+
+void ClimateStore::simulateConduction(int tile) noexcept
+{
+	bool includeVertical = (TileClimate::getConductionScheme() == PAIRWISE_CONDUCTION);
+	const std::vector<int> &offsets = includeVertical ? _pairOffsets : _sidePairOffsets;
+	const std::vector<ConductionPair> &pairs = includeVertical ? _conductionPairs : _sidePairs;
+
+	for (int p = offsets[tile]; p < offsets[tile + 1]; p++) {
+		const ConductionPair &pair = pairs[p];
+
+		LayerArrays &tenant = arrays(pair.tenant);
+		LayerArrays &owner = arrays(pair.owner);
+		int t = pair.tenant.index;
+		int o = pair.owner.index;
+
+		double heatExchanged = Mixture::conductiveExchange(tenant.temperature[t], tenant.heatCapacity[t],
+			owner.temperature[o], owner.heatCapacity[o], pair.conductivity, pair.area);
+
+		tenant.temperature[t] += heatExchanged / tenant.heatCapacity[t];
+		owner.temperature[o] -= heatExchanged / owner.heatCapacity[o];
+
+		tenant.netConductiveExchange[t] += heatExchanged;
+		owner.netConductiveExchange[o] -= heatExchanged;
+
+		if (tenant.temperature[t] <= 0 || owner.temperature[o] <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+	}
+}
+
+void ClimateStore::solveVerticalConduction(int beginTile, int endTile) noexcept
+{
+	int tileCount = getTileCount();
+	double stepHours = TileClimate::getStepHours();
+
+	for (int level = 0; level < _verticalLevels; level++) {
+		const LayerSlot *slots = &_verticalSlots[level*tileCount];
+		double *capacity = &_verticalCapacity[level*tileCount];
+		double *temperature = &_verticalTemperature[level*tileCount];
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			if (slots[tile].index == my::kFakeIndex) continue;//padding keeps capacity 1 at 0 K
+			const LayerArrays &layer = arrays(slots[tile]);
+			capacity[tile] = layer.heatCapacity[slots[tile].index];
+			temperature[tile] = layer.temperature[slots[tile].index];
+		}
+	}
+
+	//elimination up the columns
+	for (int level = 0; level < _verticalLevels; level++) {
+		const double *capacity = &_verticalCapacity[level*tileCount];
+		const double *temperature = &_verticalTemperature[level*tileCount];
+		const double *below = &_verticalConductance[level*tileCount];
+		const double *above = &_verticalConductance[(level + 1)*tileCount];
+		const double *belowCPrime = &_verticalCPrime[level*tileCount];
+		const double *belowDPrime = &_verticalDPrime[level*tileCount];
+		double *cPrime = &_verticalCPrime[(level + 1)*tileCount];
+		double *dPrime = &_verticalDPrime[(level + 1)*tileCount];
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			double belowConductance = below[tile] * stepHours;
+			double aboveConductance = above[tile] * stepHours;
+
+			double pivot = capacity[tile] + belowConductance + aboveConductance + belowConductance*belowCPrime[tile];
+			cPrime[tile] = -aboveConductance / pivot;
+			dPrime[tile] = (capacity[tile] * temperature[tile] + belowConductance*belowDPrime[tile]) / pivot;
+		}
+	}
+
+	//substitution back down
+	for (int level = _verticalLevels - 1; level >= 0; level--) {
+		const double *cPrime = &_verticalCPrime[(level + 1)*tileCount];
+		const double *dPrime = &_verticalDPrime[(level + 1)*tileCount];
+		const double *aboveSolution = &_verticalSolution[(level + 1)*tileCount];
+		double *solution = &_verticalSolution[level*tileCount];
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			solution[tile] = dPrime[tile] - cPrime[tile] * aboveSolution[tile];
+		}
+	}
+
+	//Mixture::conductTo
+	for (int level = 0; level < _verticalLevels; level++) {
+		const LayerSlot *slots = &_verticalSlots[level*tileCount];
+		const double *capacity = &_verticalCapacity[level*tileCount];
+		const double *temperature = &_verticalTemperature[level*tileCount];
+		const double *solution = &_verticalSolution[level*tileCount];
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			if (slots[tile].index == my::kFakeIndex) continue;
+			LayerArrays &layer = arrays(slots[tile]);
+			int i = slots[tile].index;
+
+			layer.netConductiveExchange[i] += capacity[tile] * (solution[tile] - temperature[tile]);
+			layer.temperature[i] = solution[tile];
+
+			if (layer.temperature[i] <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+		}
+	}
+}
+
+//Mixture::filterSolarRadiation
+double ClimateStore::filterSolar(LayerSlot slot, double solarEnergyKJ) noexcept
+{
+	if (solarEnergyKJ <= 0) { return 0; }
+
+	LayerArrays &layer = arrays(slot);
+	int i = slot.index;
+
+	if (layer.heatCapacity[i] <= 0) { LOG("ZERO HEAT CAPACITY"); exit(EXIT_FAILURE); }
+	if (layer.albedo[i] < 0 || layer.albedo[i]>1) { LOG("WEIRD ALBEDO"); exit(EXIT_FAILURE); }
+
+	//reflection
+	solarEnergyKJ *= (1 - layer.albedo[i]);
+
+	double solarAbsorbed = layer.solarAbsorptionIndex[i] * solarEnergyKJ;
+	double outputEnergyKJ = solarEnergyKJ - solarAbsorbed;
+
+	layer.hourlySolarInput[i] = solarAbsorbed;
+
+	if (!layer.emittor[i]) {
+		layer.temperature[i] += solarAbsorbed / layer.heatCapacity[i];
+	}
+
+	return outputEnergyKJ;
+}
+
+//Mixture::filterInfrared
+double ClimateStore::filterInfrared(LayerSlot slot, double infraredEnergy) noexcept
+{
+	LayerArrays &layer = arrays(slot);
+	int i = slot.index;
+
+	if (layer.heatCapacity[i] <= 0) { LOG("ZERO HEAT CAPACITY"); exit(EXIT_FAILURE); }
+
+	double infraredAbsorbed = layer.infraredAbsorptionIndex[i] * infraredEnergy;
+
+	infraredEnergy -= infraredAbsorbed;
+
+	layer.hourlyInfraredInput[i] += infraredAbsorbed;
+	layer.hourlyInfraredInputDisplay[i] += infraredAbsorbed;
+
+	if (!layer.emittor[i]) {
+		layer.temperature[i] += infraredAbsorbed / layer.heatCapacity[i];
+	}
+
+	return infraredEnergy;
+}
+
+//Mixture::emitInfrared and Mixture::handleInOutRadiation
+double ClimateStore::emitInfrared(LayerSlot slot) noexcept
+{
+	LayerArrays &layer = arrays(slot);
+	int i = slot.index;
+
+	double &temperature = layer.temperature[i];
+	double heatCapacity = layer.heatCapacity[i];
+	double input = layer.hourlyInfraredInput[i] + layer.hourlySolarInput[i];
+
+	if (heatCapacity <= 0) { LOG("ZERO HEAT CAPACITY");  exit(EXIT_FAILURE); }
+	if (temperature <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+
+	double equilibriumTemperature = Mixture::calculateEquilibriumTemperature(layer.gas[i] != 0, layer.mass[i], input);
+	layer.equilibriumTemperature[i] = equilibriumTemperature;
+
+	if (TileClimate::getRadiationScheme() == IMPLICIT_RADIATION) {
+		layer.hourlyInfraredInput[i] = 0;
+		layer.hourlyOutputRadiation[i] = Mixture::radiateImplicit(layer.gas[i] != 0, layer.mass[i], heatCapacity, temperature, input);
+		return layer.hourlyOutputRadiation[i];
+	}
+
+	double postInputTemperature = temperature + (input / heatCapacity);
+	layer.hourlyInfraredInput[i] = 0;
+
+	double preEmissions = Mixture::calculateEmissions(layer.gas[i] != 0, layer.mass[i], temperature);
+
+	double postInputOutputTemperature = postInputTemperature - (preEmissions / heatCapacity);
+
+	double correctEmissions = preEmissions;
+
+	if (temperature > equilibriumTemperature) {//cooling
+		temperature = postInputOutputTemperature;
+	}
+	else if (postInputOutputTemperature > equilibriumTemperature) {//over warming
+		correctEmissions = preEmissions + (postInputOutputTemperature - equilibriumTemperature) * heatCapacity;
+		temperature = equilibriumTemperature;
+	}
+	else {//acceptable warming
+		temperature = postInputOutputTemperature;
+	}
+
+	layer.hourlyOutputRadiation[i] = correctEmissions;
+
+	return correctEmissions;
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,160 @@
+#pragma once
+#include "globals.h"
+#include "material-column.h"
+#include <memory>
+
+namespace pleistocene {
+namespace my { class WorkerPool; }
+namespace simulation {
+namespace climate {
+
+class RadiativeTransfer;
+
+//Where a layer lives in the ClimateStore: the LayerType arrays and the slot in them
+struct LayerSlot {
+	layers::LayerType type;
+	int index;
+};
+
+//One contiguous array per field for every layer of one LayerType in the world
+struct LayerArrays {
+	std::vector<double> temperature;
+	std::vector<double> heatCapacity;
+	std::vector<double> mass;
+	std::vector<double> mols;
+	std::vector<double> albedo;
+	std::vector<double> solarAbsorptionIndex;
+	std::vector<double> infraredAbsorptionIndex;
+	std::vector<double> inertiaX;
+	std::vector<double> inertiaY;
+	std::vector<double> inertiaZ;
+
+	//hourly energy budget
+	std::vector<double> hourlySolarInput;
+	std::vector<double> hourlyInfraredInput;
+	std::vector<double> hourlyInfraredInputDisplay;
+	std::vector<double> hourlyOutputRadiation;
+	std::vector<double> netConductiveExchange;
+	std::vector<double> equilibriumTemperature;
+
+	std::vector<char> emittor;
+	std::vector<char> gas;
+
+	//the layer objects these slots mirror
+	std::vector<layers::elements::Mixture*> mixtures;
+
+	//a slot for mixture. the fields are sized for every slot at once by resizeFields, then filled by gather
+	int add(layers::elements::Mixture *mixture) noexcept;
+	void resizeFields() noexcept;
+	//keeping the capacity for the next build
+	void clear() noexcept;
+	int size() const noexcept;
+
+	void gather(int i) noexcept;
+	void scatter(int i) const noexcept;
+};
+
+//A conduction surface, flattened. Pairs are stored per owning tile in the order the object sweep visits them
+struct ConductionPair {
+	LayerSlot tenant;
+	LayerSlot owner;
+	double area;
+	double conductivity;
+};
+
+//World-wide structure-of-arrays copy of the climate state.
+//The radiation (step 1) and conduction (step 2) kernels run on the arrays instead of chasing layer pointers,
+//with the same arithmetic in the same order as the MaterialColumn/Mixture path, so results are bit-identical.
+//gatherTile copies a column's state in before step 1 and scatterTile writes it back after step 2,
+//since the remaining steps (pressure, air flow) still run on the objects.
+class ClimateStore {
+public:
+	ClimateStore() noexcept;
+	~ClimateStore() noexcept;
+	//movable, so World can swap a regenerated world's store in
+	ClimateStore(ClimateStore &&other) noexcept;
+	ClimateStore &operator=(ClimateStore &&other) noexcept;
+
+	//columns indexed by tile. must be rebuilt whenever layers or surfaces are rebuilt.
+	//the per tile parts (gathering, conduction pairs) run on pool when given
+	void build(const std::vector<layers::MaterialColumn*> &columns, my::WorkerPool *pool = nullptr) noexcept;
+	bool isBuilt() const noexcept;
+
+	static bool handlesStep(int simulationStep) noexcept;
+	static bool gathersBefore(int simulationStep) noexcept;
+	static bool scattersAfter(int simulationStep) noexcept;
+
+	void gatherTile(int tile) noexcept;
+	void scatterTile(int tile) noexcept;
+
+	//SIMULATION (per tile)
+	//=========================
+	void beginNewHour(int tile) noexcept;
+	void filterSolarRadiation(int tile, double energyKJ) noexcept;
+	void simulateInfraredRadiation(int tile) noexcept;
+	void simulateConduction(int tile) noexcept;
+
+	//sunlight and infrared for the tiles [beginTile, endTile) at once, through the RadiativeTransfer engine.
+	//when batched, step 1 only records each tile's sunlight (setSolarEnergy) and World runs this after it. ranges may run concurrently
+	void setBatchedRadiation(bool batched) noexcept;
+	bool batchesRadiationAfter(int simulationStep) const noexcept;
+	void setSolarEnergy(int tile, double energyKJ) noexcept;
+	void simulateRadiation(int beginTile, int endTile) noexcept;
+
+	//IMPLICIT_VERTICAL_CONDUCTION: MaterialColumn::simulateVerticalConduction for the tiles [beginTile, endTile).
+	//The systems are laid out level by level across tiles, so each sweep of the Thomas algorithm is a loop over tiles
+	//the compiler vectorizes. Ranges may run concurrently
+	void solveVerticalConduction(int beginTile, int endTile) noexcept;
+
+	int getTileCount() const noexcept;
+
+private:
+	LayerArrays _layers[4];//indexed by LayerType
+
+	std::vector<layers::MaterialColumn*> _columns;
+
+	//column layout. _columnSlots[_columnOffsets[tile].._columnOffsets[tile+1]) run bottom to top
+	std::vector<int> _columnOffsets;
+	std::vector<LayerSlot> _columnSlots;
+
+	//infrared path: surface layer and the (contiguous) air layers of each tile
+	std::vector<LayerSlot> _surfaceSlots;
+	std::vector<int> _airBegin;
+	std::vector<int> _airEnd;
+
+	std::vector<double> _backRadiation;
+	std::vector<double> _escapeRadiation;
+
+	bool _batchedRadiation = false;
+	std::unique_ptr<RadiativeTransfer> _radiativeTransfer;
+
+	std::vector<int> _pairOffsets;
+	std::vector<ConductionPair> _conductionPairs;
+	//the same without the top surfaces, which the vertical solve handles
+	std::vector<int> _sidePairOffsets;
+	std::vector<ConductionPair> _sidePairs;
+
+	//vertical systems, [level*tileCount + tile]. levels above a column's top are padding: kFakeIndex slots, no conductance
+	int _verticalLevels = 0;
+	std::vector<LayerSlot> _verticalSlots;
+	//with a row of zeros first, so row level holds the conductance below that level and row level + 1 the one above
+	std::vector<double> _verticalConductance;
+	//solver scratch. capacity, temperature, solution by level (solution with a row of zeros on top),
+	//cPrime and dPrime by level + 1 (a row of zeros below)
+	std::vector<double> _verticalCapacity;
+	std::vector<double> _verticalTemperature;
+	std::vector<double> _verticalSolution;
+	std::vector<double> _verticalCPrime;
+	std::vector<double> _verticalDPrime;
+
+	LayerArrays &arrays(LayerSlot slot) noexcept;
+
+	//Mixture radiation functions over a slot
+	double filterSolar(LayerSlot slot, double solarEnergyKJ) noexcept;
+	double filterInfrared(LayerSlot slot, double infraredEnergy) noexcept;
+	double emitInfrared(LayerSlot slot) noexcept;
+};
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
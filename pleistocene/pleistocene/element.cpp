@@ -1,5 +1,6 @@
 #include "element.h"
 #include "material-layer.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -7,6 +8,237 @@ namespace climate {
 namespace layers {
 namespace elements {
 
+//=====================================================================================================================
+//PROPERTY TABLES
+//=====================================================================================================================
+
+//Indexed by ElementType. Zero density or molar mass means the type isn't measured that way
+namespace {
+
+//KJ/(kg*K)
+constexpr double kSpecificHeat[kElementTypes] = {
+	0.718,//DRY_AIR
+	3.985,//WATER_VAPOR
+	4.186,//CLOUD
+	4.186,//WATER
+	2.05,//ICE
+	2.05,//SNOW
+	0.80,//SAND (dry)
+	0.80,//SILT (dry)
+	0.92,//CLAY (dry)
+	0.92,//ROCK, say...sandstone
+	0.84//BEDROCK, say...unfractured metamorphic rock (or basalt)
+};
+
+//KJ/kg
+//heat released(+) going from "from" to "to". the backward transformations consume the same heat(-)
+struct LatentHeat {
+	ElementType from;
+	ElementType to;
+	double heat;
+};
+constexpr LatentHeat kLatentHeat[] = {
+	{ ICE, SNOW, 0 },
+	{ ICE, WATER, 334 },
+	{ ICE, CLOUD, 334 },
+	{ ICE, WATER_VAPOR, 2599 },
+
+	{ SNOW, WATER, 334 },
+	{ SNOW, CLOUD, 334 },
+	{ SNOW, WATER_VAPOR, 2599 },
+
+	{ WATER, CLOUD, 0 },
+	{ WATER, WATER_VAPOR, 2265 },
+
+	{ CLOUD, WATER_VAPOR, 2265 }
+};
+
+//kg/m3
+constexpr double kDensity[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	1000,//CLOUD
+	1000,//WATER
+	961,//ICE
+	400,//SNOW
+	1520,//SAND
+	1280,//SILT
+	1200,//CLAY
+	2400,//ROCK
+	2700//BEDROCK
+};
+
+//kg/mol
+constexpr double kMolarMass[kElementTypes] = {
+	air::Md,//DRY_AIR
+	air::Mv,//WATER_VAPOR
+	air::Mv,//CLOUD
+	air::Mv,//WATER
+	air::Mv,//ICE
+	air::Mv//SNOW
+};
+
+//solid/liquid/gas (natural state for element). solid can also be used as particulate (except for rocks)
+constexpr State kState[kElementTypes] = {
+	GAS,//DRY_AIR
+	GAS,//WATER_VAPOR
+	DROPLET,//CLOUD
+	LIQUID,//WATER
+	SOLID,//ICE
+	SOLID,//SNOW
+	SOLID,//SAND
+	SOLID,//SILT
+	SOLID,//CLAY
+	SOLID,//ROCK
+	SOLID//BEDROCK
+};
+
+//permeability. Meters per hour per unit pressure gradient
+constexpr double kPermeability[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	0,//CLOUD
+	0,//WATER
+	0,//ICE
+	0,//SNOW
+	1e-1,//SAND
+	1e-3,//SILT
+	1e-5,//CLAY
+	1e-4,//ROCK
+	1e-7//BEDROCK
+};
+
+//Porosity is defined as the void space of a rock or unconsolidated material
+//n=(V_void)/(V_total)
+constexpr double kPorosity[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	0,//CLOUD
+	0,//WATER
+	0,//ICE
+	0,//SNOW
+	0.4,//SAND
+	0.48,//SILT
+	0.47,//CLAY
+	0.3,//ROCK
+	0.1//BEDROCK
+};
+
+//particle density, assuming spherical volume (so snow gets super low density) kg/m3
+constexpr double kParticleDensity[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	0,//CLOUD
+	0,//WATER
+	961,//ICE
+	200,//SNOW ?
+	2659,//SAND
+	2798,//SILT
+	2837//CLAY
+};
+
+//particle radius (m)
+constexpr double kParticleRadius[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	0,//CLOUD
+	0,//WATER
+	5 * 1e-3,//ICE, hail
+	2 * 1e-3,//SNOW, falling snow
+	1 * 1e-3,//SAND
+	2 * 1e-5,//SILT
+	1 * 1e-6//CLAY
+};
+
+//Viscosity. This should really depend on temperature
+constexpr double kDynamicViscosity[kElementTypes] = {
+	1.8 * 1e-5,//DRY_AIR
+	1.8 * 1e-5,//WATER_VAPOR
+	0,//CLOUD
+	1 * 1e-3//WATER
+};
+
+//accepted type mixtures (can't add rocks to a gas). Indexed by State, a bit per ElementType
+constexpr uint16_t typeBit(ElementType type) { return uint16_t(1u << type); }
+constexpr uint16_t kAcceptedTypes[GAS + 1] = {
+	0,//NO_STATE
+	typeBit(ICE) | typeBit(SNOW) | typeBit(SAND) | typeBit(SILT) | typeBit(CLAY) | typeBit(ROCK) | typeBit(BEDROCK),//SOLID
+	typeBit(ICE) | typeBit(SNOW) | typeBit(SAND) | typeBit(SILT) | typeBit(CLAY),//PARTICULATE
+	typeBit(WATER),//LIQUID
+	typeBit(CLOUD),//DROPLET
+	typeBit(DRY_AIR) | typeBit(WATER_VAPOR)//GAS
+};
+
+//reflective index for solids/water surface
+constexpr double kAlbedo[kElementTypes] = {
+	0,//DRY_AIR
+	0,//WATER_VAPOR
+	0,//CLOUD
+	0.06,//WATER
+	0.6,//ICE
+	0.85,//SNOW
+	0.4,//SAND
+	0.3,//SILT
+	0.2,//CLAY
+	0.1,//ROCK
+	0.0//BEDROCK
+};
+
+//reflective index for diffuse elements (reflected/kg)
+constexpr double kReflectivity[kElementTypes] = {
+	2.6 * 1e-5,//DRY_AIR, cloudless (was 2.2 * 1e-5)
+	2.2 * 1e-5,//WATER_VAPOR
+	1 * 1e-1,//CLOUD, stub
+	0,//WATER
+	1 * 1e-1,//ICE, while particulate
+	1 * 1e-1,//SNOW, while particulate
+	1 * 1e-5,//SAND, while particulate
+	1 * 1e-5,//SILT, while particulate
+	1 * 1e-5//CLAY, while particulate
+};
+
+//solar absorption rate (proportion absorbed/kg)
+constexpr double kSolarAbsorptivity[kElementTypes] = {
+	2.2 * 1e-5,//DRY_AIR
+	2.2 * 1e-5,//WATER_VAPOR
+	2.2 * 1e-5,//CLOUD
+	2.2 * 1e-4,//WATER, eh
+	2.2 * 1e-5,//ICE, while particulate
+	2.2 * 1e-5,//SNOW, while particulate
+	1 * 1e-3,//SAND, while particulate
+	1 * 1e-3,//SILT, while particulate
+	1 * 1e-3//CLAY, while particulate
+};
+
+//Infrared absorption rate (proportion absorbed/kg). stub
+constexpr double kInfraredAbsorptivity[kElementTypes] = {
+	2.0 * 1e-4,//DRY_AIR
+	1 * 1e-3,//WATER_VAPOR
+	1 * 1e-3,//CLOUD
+	1 * 1e-2,//WATER
+	2.2 * 1e-5,//ICE, while particulate
+	2.2 * 1e-5,//SNOW, while particulate
+	1 * 1e-3,//SAND, while particulate
+	1 * 1e-3,//SILT, while particulate
+	1 * 1e-3//CLAY, while particulate
+};
+
+constexpr const char *kElementName[kElementTypes] = {
+	"Dry Air",
+	"Water Vapor",
+	"Cloud",
+	"Liquid Water",
+	"Ice",
+	"Snow",
+	"Sand",
+	"Silt",
+	"Clay",
+	"Rock",
+	"Bedrock"
+};
+
+}//namespace
+
 //=====================================================================================================================
 //ELEMENT
 //=====================================================================================================================
@@ -20,7 +252,7 @@ Element::Element(ConstructorType constructorType, ElementType elementType, doubl
 
 	_elementType = elementType;
 
-	if (state == NO_STATE) { _state = _stateMap.at(_elementType); }
+	if (state == NO_STATE) { _state = kState[_elementType]; }
 	else { _state = state; }
 
 	if (_elementType == WATER || _elementType == ICE || _elementType == SNOW || _elementType == WATER_VAPOR || _elementType == CLOUD) {
@@ -30,32 +262,32 @@ Element::Element(ConstructorType constructorType, ElementType elementType, doubl
 	switch (constructorType) {
 	case(VOLUME) :
 		_volume = value;
-		if (_densityMap.count(_elementType) == 0) { LOG("Not a Volume substance"); exit(EXIT_FAILURE); } //NOEXCEPT
-		if (_state == PARTICULATE) { _mass = _volume*_particleDensityMap.at(_elementType); }
-		else { _mass = _volume*_densityMap.at(_elementType); }
+		if (kDensity[_elementType] == 0) { LOG("Not a Volume substance"); exit(EXIT_FAILURE); } //NOEXCEPT
+		if (_state == PARTICULATE) { _mass = _volume*kParticleDensity[_elementType]; }
+		else { _mass = _volume*kDensity[_elementType]; }
 		break;
 	case(MOLAR) :
 		_mols = value;
-		if (_molarMassMap.count(_elementType) == 0) { LOG("Not a Mol substance"); exit(EXIT_FAILURE); } //NOEXCEPT
-		_mass = _mols*_molarMassMap.at(_elementType);
+		if (kMolarMass[_elementType] == 0) { LOG("Not a Mol substance"); exit(EXIT_FAILURE); } //NOEXCEPT
+		_mass = _mols*kMolarMass[_elementType];
 		break;
 	case(MASS) :
 		_mass = value;
 		switch (_state) {
 		case(SOLID) :
-			_volume = _mass / _densityMap.at(_elementType);
+			_volume = _mass / kDensity[_elementType];
 			break;
 		case(PARTICULATE) :
-			_volume = _mass / _particleDensityMap.at(_elementType);
+			_volume = _mass / kParticleDensity[_elementType];
 			break;
 		case(LIQUID) :
-			_volume = _mass / _densityMap.at(_elementType);
+			_volume = _mass / kDensity[_elementType];
 			break;
 		case(DROPLET) :
-			_volume = _mass / _densityMap.at(_elementType);
+			_volume = _mass / kDensity[_elementType];
 			break;
 		case(GAS) :
-			_mols = _mass / _molarMassMap.at(_elementType);
+			_mols = _mass / kMolarMass[_elementType];
 			break;
 		}
 		break;
@@ -70,24 +302,12 @@ void Element::combineLike(Element like) noexcept {
 
 	_mass += like._mass;
 
-	if (_densityMap.count(_elementType)) {//if density defined
-		_volume = _mass / _densityMap.at(_elementType);
-	}
-
-	if (_molarMassMap.count(_elementType)) {//if molar mass defined
-		_mols = _mass / _molarMassMap.at(_elementType);
-	}
+	sizeFromMass();
 }
 void Element::addMass(double mass) noexcept {
 	_mass += abs(mass);
 
-	if (_densityMap.count(_elementType)) {//if density defined
-		_volume = _mass / _densityMap.at(_elementType);
-	}
-
-	if (_molarMassMap.count(_elementType)) {//if molar mass defined
-		_mols = _mass / _molarMassMap.at(_elementType);
-	}
+	sizeFromMass();
 }
 double Element::pullMass(double massRequested) noexcept {
 	double massContained = _mass;
@@ -100,13 +320,7 @@ double Element::pullMass(double massRequested) noexcept {
 		return massContained;
 	}
 	else {
-		if (_densityMap.count(_elementType)) {//if density defined
-			_volume = _mass / _densityMap.at(_elementType);
-		}
-
-		if (_molarMassMap.count(_elementType)) {//if molar mass defined
-			_mols = _mass / _molarMassMap.at(_elementType);
-		}
+		sizeFromMass();
 
 		return massRequested;
 	}
@@ -121,12 +335,16 @@ void Element::resizeBy(double proportion) noexcept {
 
 	_mass *= proportion;
 
-	if (_densityMap.count(_elementType)) {//if density defined
-		_volume = _mass / _densityMap.at(_elementType);
+	sizeFromMass();
+}
+
+void Element::sizeFromMass() noexcept {
+	if (kDensity[_elementType] != 0) {//if density defined
+		_volume = _mass / kDensity[_elementType];
 	}
 
-	if (_molarMassMap.count(_elementType)) {//if molar mass defined
-		_mols = _mass / _molarMassMap.at(_elementType);
+	if (kMolarMass[_elementType] != 0) {//if molar mass defined
+		_mols = _mass / kMolarMass[_elementType];
 	}
 }
 
@@ -138,7 +356,7 @@ std::vector<std::string> Element::getMessages() const noexcept {
 	std::vector<std::string> messages;
 
 	messages.push_back(" ");
-	messages.push_back(_elementNameMap.at(_elementType));
+	messages.push_back(kElementName[_elementType]);
 	std::stringstream stream;
 	stream << "Mass: " << my::double2string(_mass) << " kg";
 	messages.push_back(stream.str());
@@ -149,351 +367,51 @@ std::vector<std::string> Element::getMessages() const noexcept {
 
 ElementType Element::getElementType() const noexcept { return _elementType; }
 State Element::getState() const noexcept { return _state; }
-double Element::getHeatCapacity() const noexcept { return _mass*_specificHeatMap.at(_elementType); }
+double Element::getHeatCapacity() const noexcept { return _mass*kSpecificHeat[_elementType]; }
 
 double Element::getAlbedo() const noexcept {
-	if (_state == SOLID || _state == LIQUID) { return _albedoMap.at(_elementType); }
-	else { return std::min(_reflectivityMap.at(_elementType)*_mass, 1.0); }
+	if (_state == SOLID || _state == LIQUID) { return kAlbedo[_elementType]; }
+	else { return std::min(kReflectivity[_elementType]*_mass, 1.0); }
 }
 double Element::getSolarAbsorptivity() const noexcept {
 	if (_state == SOLID) { return 1; }
-	else { return (_solarAbsorptivityMap.at(_elementType)*_mass); }
+	else { return (kSolarAbsorptivity[_elementType]*_mass); }
 }
 double Element::getInfraredAbsorptivity() const noexcept {
 	if (_state == SOLID) { return 1; }
-	else { return (_infraredAbsorptivityMap.at(_elementType)*_mass); }
+	else { return (kInfraredAbsorptivity[_elementType]*_mass); }
 }
 
 double Element::getMass() const noexcept { return _mass; }
 double Element::getVolume() const noexcept { return _volume; }
 double Element::getMols() const noexcept { return _mols; }
-double Element::getVoidSpace() const noexcept { return _volume*_porosityMap.at(_elementType); }
-double Element::getPermeability() const noexcept { return _permeabilityMap.at(_elementType); }
+double Element::getVoidSpace() const noexcept { return _volume*kPorosity[_elementType]; }
+double Element::getPermeability() const noexcept { return kPermeability[_elementType]; }
 
 bool Element::getStateConflict(State state) const noexcept {
 	//check if this type is in the "state" list of accepted types 
-	if (_acceptedTypesMap.at(state).count(_elementType)) { return false; }//no conflict}
-	else { return true; }//conflict}
-}
-
-
-//=====================================================================================================================
-//PROPERTY MAPS
-//=====================================================================================================================
-
-ElementPropertyMap Element::buildSpecificHeatMap() noexcept {
-	ElementPropertyMap specificHeat;
-	specificHeat[DRY_AIR] = 0.718;
-	specificHeat[WATER_VAPOR] = 3.985;
-	specificHeat[CLOUD] = 4.186;
-
-	specificHeat[WATER] = 4.186;
-	specificHeat[SNOW] = 2.05;
-	specificHeat[ICE] = 2.05;
-
-	specificHeat[BEDROCK] = 0.84;//say...unfractured metamorphic rock (or basalt)
-	specificHeat[ROCK] = 0.92;//say...sandstone
-	specificHeat[SAND] = 0.80;//(dry)
-	specificHeat[SILT] = 0.80;//(dry)
-	specificHeat[CLAY] = 0.92;//(dry)
-
-	return specificHeat;
-}
-const ElementPropertyMap Element::_specificHeatMap = Element::buildSpecificHeatMap();
-
-std::map<ElementCoupling, double> Element::buildLatentHeatMap() noexcept {
-	std::map<ElementCoupling, double> latentHeat;
-
-	latentHeat[ElementCoupling(ICE, SNOW)] = 0;
-	latentHeat[ElementCoupling(ICE, WATER)] = 334;
-	latentHeat[ElementCoupling(ICE, CLOUD)] = 334;
-	latentHeat[ElementCoupling(ICE, WATER_VAPOR)] = 2599;
-
-	latentHeat[ElementCoupling(SNOW, WATER)] = 334;
-	latentHeat[ElementCoupling(SNOW, CLOUD)] = 334;
-	latentHeat[ElementCoupling(SNOW, WATER_VAPOR)] = 2599;
-
-	latentHeat[ElementCoupling(WATER, CLOUD)] = 0;
-	latentHeat[ElementCoupling(WATER, WATER_VAPOR)] = 2265;
-
-	latentHeat[ElementCoupling(CLOUD, WATER_VAPOR)] = 2265;
-
-
-	std::map<ElementCoupling, double> fullLatentHeat;
-
-
-	for (auto const &element : latentHeat) {
-		fullLatentHeat[element.first] = element.second;//forward transformations
-		fullLatentHeat[ElementCoupling(element.first.second, element.first.first)] =
-			-element.second;//backward transformations
-	}
-
-	return fullLatentHeat;
+	return !(kAcceptedTypes[state] & typeBit(_elementType));
 }
-const std::map<ElementCoupling, double> Element::_latentHeatMap = Element::buildLatentHeatMap();
-
-ElementPropertyMap Element::buildDensityMap() noexcept {
-	ElementPropertyMap density;
 
-	density[CLOUD] = 1000;
-	density[WATER] = 1000;
-	density[SNOW] = 400;
-	density[ICE] = 961;
-
-	density[BEDROCK] = 2700;
-	density[ROCK] = 2400;
-	density[SAND] = 1520;
-	density[SILT] = 1280;
-	density[CLAY] = 1200;
-
-	return density;
+void Element::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_elementType);
+	writer.write(_volume);
+	writer.write(_mols);
+	writer.write(_mass);
+	writer.write(_waterForm);
+	writer.write(_state);
 }
-const ElementPropertyMap Element::_densityMap = Element::buildDensityMap();
-
-ElementPropertyMap Element::buildMolarMassMap() noexcept {
-	
-	using namespace air;
-	ElementPropertyMap molarMass;
 
-	molarMass[DRY_AIR] = Md;
-	molarMass[WATER_VAPOR] = Mv;
-	molarMass[CLOUD] = Mv;
-	molarMass[WATER] = Mv;
-	molarMass[SNOW] = Mv;
-	molarMass[ICE] = Mv;
-
-	return molarMass;
+void Element::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	reader.read(_elementType);
+	reader.read(_volume);
+	reader.read(_mols);
+	reader.read(_mass);
+	reader.read(_waterForm);
+	reader.read(_state);
 }
-const ElementPropertyMap Element::_molarMassMap = Element::buildMolarMassMap();
-
-std::map<ElementType, State> Element::buildStateMap() noexcept {
-	
-	std::map<ElementType, State> stateMap;
-
-	//now somewhat redundant as I like accepted types map more
-
-	stateMap[DRY_AIR] = GAS;
-	stateMap[WATER_VAPOR] = GAS;
-
-	stateMap[CLOUD] = DROPLET;
-
-	stateMap[WATER] = LIQUID;
-
-	//solid can also be used as particulate (except for rocks)
-	stateMap[SNOW] = SOLID;
-	stateMap[ICE] = SOLID;
-	stateMap[BEDROCK] = SOLID;
-	stateMap[ROCK] = SOLID;
-	stateMap[SAND] = SOLID;
-	stateMap[SILT] = SOLID;
-	stateMap[CLAY] = SOLID;
-	return stateMap;
-}
-const std::map<ElementType, State> Element::_stateMap = Element::buildStateMap();
-
-ElementPropertyMap Element::buildPermeabilityMap() noexcept {
-	
-	ElementPropertyMap permeabilityMap;
-
-	//meters per hour
-	permeabilityMap[ICE] = 0;
-	permeabilityMap[SNOW] = 0;
-	permeabilityMap[BEDROCK] = pow(10, -7);
-	permeabilityMap[ROCK] = pow(10, -4);
-	permeabilityMap[SAND] = pow(10, -1);
-	permeabilityMap[SILT] = pow(10, -3);
-	permeabilityMap[CLAY] = pow(10, -5);
-
-	return permeabilityMap;
-}
-const ElementPropertyMap Element::_permeabilityMap = Element::buildPermeabilityMap();
-
-ElementPropertyMap Element::buildPorosityMap() noexcept {
-	
-	ElementPropertyMap porosityMap;
-
-	//Porosity is defined as the void space of a rock or unconsolidated material
-	//n=(V_void)/(V_total)
-	porosityMap[ICE] = 0;
-	porosityMap[SNOW] = 0;
-	porosityMap[BEDROCK] = 0.1;
-	porosityMap[ROCK] = 0.3;
-	porosityMap[SAND] = 0.4;
-	porosityMap[SILT] = 0.48;
-	porosityMap[CLAY] = 0.47;
-
-	return porosityMap;
-}
-const ElementPropertyMap Element::_porosityMap = Element::buildPorosityMap();
-
-ElementPropertyMap Element::buildParticleDensityMap() noexcept {
-	
-	ElementPropertyMap particleDensityMap;
-
-	particleDensityMap[ICE] = 961;
-	particleDensityMap[SNOW] = 200;//?
-	particleDensityMap[SAND] = 2659;
-	particleDensityMap[SILT] = 2798;
-	particleDensityMap[CLAY] = 2837;
-
-	return particleDensityMap;
-}
-const ElementPropertyMap Element::_particleDensityMap = Element::buildParticleDensityMap();
-
-ElementPropertyMap Element::buildParticleRadiusMap() noexcept {
-	
-	ElementPropertyMap particleRadiusMap;
-
-	particleRadiusMap[ICE] = 5 * pow(10, -3);//hail
-	particleRadiusMap[SNOW] = 2 * pow(10, -3);//falling snow
-	particleRadiusMap[SAND] = 1 * pow(10, -3);
-	particleRadiusMap[SILT] = 2 * pow(10, -5);
-	particleRadiusMap[CLAY] = 1 * pow(10, -6);
-
-	return particleRadiusMap;
-}
-const ElementPropertyMap Element::_particleRadiusMap = Element::buildParticleRadiusMap();
-
-ElementPropertyMap Element::buildDynamicViscosityMap() noexcept {
-	
-	ElementPropertyMap dynamicViscosityMap;
-
-	//This should really depend on temperature
-	dynamicViscosityMap[DRY_AIR] = 1.8 * pow(10, -5);
-	dynamicViscosityMap[WATER_VAPOR] = 1.8 * pow(10, -5);
-	dynamicViscosityMap[WATER] = 1 * pow(10, -3);
-
-	return dynamicViscosityMap;
-}
-const ElementPropertyMap Element::_dynamicViscosityMap = Element::buildDynamicViscosityMap();
-
-std::map<State, std::set<ElementType>> Element::buildAcceptedTypesMap() noexcept {
-	
-	std::map<State, std::set<ElementType>> acceptedTypesMap;
-
-	std::set<ElementType> gasTypes{ DRY_AIR, WATER_VAPOR };
-	acceptedTypesMap[GAS] = gasTypes;
-
-	std::set<ElementType> dropletTypes{ CLOUD };
-	acceptedTypesMap[DROPLET] = dropletTypes;
-
-	std::set<ElementType> liquidTypes{ WATER };
-	acceptedTypesMap[LIQUID] = liquidTypes;
-
-	std::set<ElementType> particulateTypes{ ICE,SNOW,SAND,SILT,CLAY };
-	acceptedTypesMap[PARTICULATE] = particulateTypes;
-
-	std::set<ElementType> solidTypes{ ICE,SNOW,SAND,SILT,CLAY,ROCK,BEDROCK };
-	acceptedTypesMap[SOLID] = solidTypes;
-
-	return acceptedTypesMap;
-}
-const std::map<State, std::set<ElementType>> Element::_acceptedTypesMap = Element::buildAcceptedTypesMap();
-
-ElementPropertyMap Element::buildAlbedoMap() noexcept {
-	
-	ElementPropertyMap albedo;
-
-	albedo[WATER] = 0.06;
-	albedo[SNOW] = 0.85;
-	albedo[ICE] = 0.6;
-
-	albedo[BEDROCK] = 0.0;
-	albedo[ROCK] = 0.1;
-	albedo[SAND] = 0.4;
-	albedo[SILT] = 0.3;
-	albedo[CLAY] = 0.2;
-	return albedo;
-}
-const ElementPropertyMap Element::_albedoMap = Element::buildAlbedoMap();
-
-ElementPropertyMap Element::buildReflectivityMap() noexcept {
-	
-	ElementPropertyMap reflectivityMap;
-
-	//Cloudless:
-	reflectivityMap[DRY_AIR] = 2.6*pow(10, -5);
-
-	//reflectivityMap[DRY_AIR] = 2.2*pow(10, -5);
-	reflectivityMap[WATER_VAPOR] = 2.2*pow(10, -5);
-
-	reflectivityMap[CLOUD] = 1 * pow(10, -1);//stub
-
-	reflectivityMap[SNOW] = 1 * pow(10, -1);//while particulate
-	reflectivityMap[ICE] = 1 * pow(10, -1);//while particulate
-
-	reflectivityMap[SAND] = 1 * pow(10, -5);//while particulate
-	reflectivityMap[SILT] = 1 * pow(10, -5);//while particulate
-	reflectivityMap[CLAY] = 1 * pow(10, -5);//while particulate
-
-	return reflectivityMap;
-}
-const ElementPropertyMap Element::_reflectivityMap = Element::buildReflectivityMap();
-
-ElementPropertyMap Element::buildSolarAbsorptivityMap() noexcept {
-	
-	ElementPropertyMap solarAbsorptivityMap;
-
-	solarAbsorptivityMap[DRY_AIR] = 2.2*pow(10, -5);
-	solarAbsorptivityMap[WATER_VAPOR] = 2.2*pow(10, -5);
-	solarAbsorptivityMap[CLOUD] = 2.2*pow(10, -5);
-
-	solarAbsorptivityMap[WATER] = 2.2*pow(10, -4);//eh
-
-	solarAbsorptivityMap[SNOW] = 2.2*pow(10, -5);//while particulate
-	solarAbsorptivityMap[ICE] = 2.2*pow(10, -5);//while particulate
-
-	solarAbsorptivityMap[SAND] = 1 * pow(10, -3);//while particulate
-	solarAbsorptivityMap[SILT] = 1 * pow(10, -3);//while particulate
-	solarAbsorptivityMap[CLAY] = 1 * pow(10, -3);//while particulate
-
-	return solarAbsorptivityMap;
-}
-const ElementPropertyMap Element::_solarAbsorptivityMap = Element::buildSolarAbsorptivityMap();
-
-ElementPropertyMap Element::buildInfraredAbsorptivityMap() noexcept {
-	
-	ElementPropertyMap infraredAbsorptivityMap;
-
-	//stub
-	infraredAbsorptivityMap[DRY_AIR] = 2.0*pow(10, -4);
-	infraredAbsorptivityMap[WATER_VAPOR] = 1 * pow(10, -3);
-
-	infraredAbsorptivityMap[CLOUD] = 1 * pow(10, -3);
-
-	infraredAbsorptivityMap[WATER] = 1 * pow(10, -2);
-
-	infraredAbsorptivityMap[SNOW] = 2.2*pow(10, -5);//while particulate
-	infraredAbsorptivityMap[ICE] = 2.2*pow(10, -5);//while particulate
-
-	infraredAbsorptivityMap[SAND] = 1 * pow(10, -3);//while particulate
-	infraredAbsorptivityMap[SILT] = 1 * pow(10, -3);//while particulate
-	infraredAbsorptivityMap[CLAY] = 1 * pow(10, -3);//while particulate
-
-	return infraredAbsorptivityMap;
-}
-const ElementPropertyMap Element::_infraredAbsorptivityMap = Element::buildInfraredAbsorptivityMap();
-
-std::map<ElementType, std::string> Element::buildElementNameMap() noexcept {
-	std::map<ElementType, std::string> elementNameMap;
-	elementNameMap[DRY_AIR] = "Dry Air";
-	elementNameMap[WATER_VAPOR] = "Water Vapor";
-	elementNameMap[CLOUD] = "Cloud";
-
-	elementNameMap[WATER] = "Liquid Water";
-	elementNameMap[SNOW] = "Snow";
-	elementNameMap[ICE] = "Ice";
-
-	elementNameMap[BEDROCK] = "Bedrock";
-	elementNameMap[ROCK] = "Rock";
-	elementNameMap[SAND] = "Sand";
-	elementNameMap[SILT] = "Silt";
-	elementNameMap[CLAY] = "Clay";
-
-	return elementNameMap;
-}
-const std::map<ElementType, std::string> Element::_elementNameMap = Element::buildElementNameMap();
-
 
 
 }//namespace elements
@@ -1,6 +1,6 @@
 #pragma once
 #include "globals.h"
-#include <set>
+#include <array>
 
 namespace pleistocene {
 namespace simulation {
@@ -31,10 +31,7 @@ enum ElementType {
 
 };
 
-typedef std::map<const ElementType, double> ElementPropertyMap;
-typedef std::pair<const ElementType, const ElementType> ElementCoupling;
-typedef std::pair<const ElementType, Element> ElementPair;
-typedef std::map<const ElementType, Element> ElementMap;
+const int kElementTypes = BEDROCK + 1;
 
 
 enum ConstructorType {
@@ -97,79 +94,71 @@ public:
 	double getPermeability()const noexcept;
 	bool getStateConflict(State state)const noexcept;
 
-private:
-	//======================================================
-	//PROPERTY MAPS
-	//======================================================
-
-	//KJ/(kg*K)
-	static const ElementPropertyMap _specificHeatMap;
-	static ElementPropertyMap buildSpecificHeatMap() noexcept;
-
-	//KJ/kg
-	//heat released(+) or consumed(-) in transition from "first" to "second"
-	static const std::map<ElementCoupling, double> _latentHeatMap;
-	static std::map<ElementCoupling, double> buildLatentHeatMap() noexcept;
-
-
-
-	//kg/m3
-	static const ElementPropertyMap _densityMap;//maybe add specific volume map (m3/kg)
-	static ElementPropertyMap buildDensityMap() noexcept;
-
-	//kg/mol
-	static const ElementPropertyMap _molarMassMap;//maybe add specific... mols? (mols/kg)
-	static ElementPropertyMap buildMolarMassMap() noexcept;
-
-	//solid/liquid/gas (natural state for element)
-	static const std::map<ElementType, State> _stateMap;
-	static std::map<ElementType, State> buildStateMap() noexcept;
-
-	//permeability. Meters per hour per unit pressure gradient
-	static const ElementPropertyMap _permeabilityMap;
-	static ElementPropertyMap buildPermeabilityMap() noexcept;
-
-	//porousness. Void Space per total volume
-	static const ElementPropertyMap _porosityMap;
-	static ElementPropertyMap buildPorosityMap() noexcept;
-
-	//particle density, assuming spherical volume (so snow gets super low density) kg/m3
-	static const ElementPropertyMap _particleDensityMap;
-	static ElementPropertyMap buildParticleDensityMap() noexcept;
-
-	//particle radius (m)
-	static const ElementPropertyMap _particleRadiusMap;
-	static ElementPropertyMap buildParticleRadiusMap() noexcept;
+	//checkpoint
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
 
-	//Viscosity
-	static const ElementPropertyMap _dynamicViscosityMap;
-	static ElementPropertyMap buildDynamicViscosityMap() noexcept;
-
-	//accepted type mixtures (can't add rocks to a gas)
-	static const std::map<State, std::set<ElementType>> _acceptedTypesMap;
-	static std::map<State, std::set<ElementType>> buildAcceptedTypesMap() noexcept;
-
-
-	//reflective index for solids/water surface 
-	static const ElementPropertyMap _albedoMap;
-	static ElementPropertyMap buildAlbedoMap() noexcept;
-
-	//reflective index for diffuse elements (reflected/kg)
-	static const ElementPropertyMap _reflectivityMap;
-	static ElementPropertyMap buildReflectivityMap() noexcept;
-
-	//solar absorption rate (proportion absorbed/kg)
-	static const ElementPropertyMap _solarAbsorptivityMap;
-	static ElementPropertyMap buildSolarAbsorptivityMap() noexcept;
-
-	//Infrared absorption rate (proportion absorbed/kg)
-	static const ElementPropertyMap _infraredAbsorptivityMap;
-	static ElementPropertyMap buildInfraredAbsorptivityMap() noexcept;
+private:
+	//recompute volume and mols from mass, for the measures this type defines
+	void sizeFromMass() noexcept;
+};
 
-	static const std::map<ElementType, std::string> _elementNameMap;
-	static std::map<ElementType, std::string> buildElementNameMap() noexcept;
+//=====================================================================================================================
+//ELEMENT SET
+//=====================================================================================================================
 
+//A mixture's elements: one slot per ElementType and a bit for each slot in use. Iterating visits the present
+//elements in ElementType order (as the std::map this replaces did), so sums over them come out the same
+class ElementSet {
+
+	std::array<Element, kElementTypes> _slots;
+	uint16_t _present = 0;
+
+	template <typename SlotType>
+	class BasicIterator {
+		SlotType *_slots;
+		uint16_t _remaining;//presence bits from _index up
+		int _index;
+
+		void seek() noexcept { while (_remaining && !(_remaining & 1)) { _remaining >>= 1; _index++; } }
+	public:
+		BasicIterator(SlotType *slots, uint16_t present) noexcept : _slots(slots), _remaining(present), _index(0) { seek(); }
+		SlotType &operator*() const noexcept { return _slots[_index]; }
+		SlotType *operator->() const noexcept { return &_slots[_index]; }
+		BasicIterator &operator++() noexcept { _remaining >>= 1; _index++; seek(); return *this; }
+		bool operator!=(const BasicIterator &other) const noexcept { return _remaining != other._remaining; }
+		bool operator==(const BasicIterator &other) const noexcept { return _remaining == other._remaining; }
+	};
 
+public:
+	typedef BasicIterator<Element> iterator;
+	typedef BasicIterator<const Element> const_iterator;
+
+	bool contains(ElementType type) const noexcept { return (_present >> type) & 1; }
+	//slot for a present element
+	Element &operator[](ElementType type) noexcept { return _slots[type]; }
+	const Element &operator[](ElementType type) const noexcept { return _slots[type]; }
+
+	void insert(const Element &element) noexcept
+	{
+		_slots[element.getElementType()] = element;
+		_present |= uint16_t(1u << element.getElementType());
+	}
+	void erase(ElementType type) noexcept { _present &= uint16_t(~(1u << type)); }
+	void clear() noexcept { _present = 0; }
+
+	int size() const noexcept
+	{
+		int count = 0;
+		for (uint16_t bits = _present; bits; bits &= bits - 1) { count++; }
+		return count;
+	}
+	bool empty() const noexcept { return _present == 0; }
+
+	iterator begin() noexcept { return iterator(_slots.data(), _present); }
+	iterator end() noexcept { return iterator(_slots.data(), 0); }
+	const_iterator begin() const noexcept { return const_iterator(_slots.data(), _present); }
+	const_iterator end() const noexcept { return const_iterator(_slots.data(), 0); }
 };
 
 }//namespace elements
@@ -0,0 +1,237 @@
+#include "field-output.h"
+#include <cstring>
+#include <limits>
+
+namespace pleistocene {
+namespace simulation {
+
+//======================================
+//FIELDS
+//======================================
+
+bool FieldSpec::parse(const std::string &text, FieldSpec &field) noexcept
+{
+	std::vector<std::string> parts;
+	std::stringstream stream(text);
+	std::string part;
+	while (std::getline(stream, part, ':')) parts.push_back(part);
+
+	if (parts.empty() || parts.size() > 3) return false;
+
+	field = FieldSpec();
+	field._name = text;
+
+	const std::string &quantity = parts[0];
+	if (quantity == "elevation") { field._statRequest._statType = ELEVATION; }
+	else if (quantity == "temperature") { field._statRequest._statType = TEMPERATURE; }
+	else if (quantity == "material") { field._statRequest._statType = MATERIAL_PROPERTIES; }
+	else if (quantity == "pressure") { field._statRequest._statType = PRESSURE; }
+	else if (quantity == "flow") { field._statRequest._statType = FLOW; }
+	else if (quantity == "advection-x") { field._quantity = FIELD_ADVECTION_X; }
+	else if (quantity == "advection-y") { field._quantity = FIELD_ADVECTION_Y; }
+	else if (quantity == "back-radiation") { field._quantity = FIELD_BACK_RADIATION; }
+	else if (quantity == "escape-radiation") { field._quantity = FIELD_ESCAPE_RADIATION; }
+	else return false;
+
+	if (parts.size() > 1) {
+		const std::string &section = parts[1];
+		if (section == "surface") { field._statRequest._section = SURFACE_; }
+		else if (section == "horizon") { field._statRequest._section = HORIZON_; }
+		else if (section == "earth") { field._statRequest._section = EARTH_; }
+		else if (section == "sea") { field._statRequest._section = SEA_; }
+		else if (section == "air") { field._statRequest._section = AIR_; }
+		else return false;
+	}
+
+	if (parts.size() > 2) {
+		field._statRequest._layer = atoi(parts[2].c_str());
+	}
+
+	return true;
+}
+
+float FieldSpec::sample(const climate::TileClimate &tileClimate) const noexcept
+{
+	const climate::layers::MaterialColumn &column = tileClimate.getMaterialColumn();
+
+	switch (_quantity) {
+	case(FIELD_STATISTIC) : {
+		double value = column.getStatistic(_statRequest);
+		if (value == my::kFakeDouble) return std::numeric_limits<float>::quiet_NaN();
+		return float(value);
+	}
+	case(FIELD_ADVECTION_X) : return float(column.getAdvection(_statRequest)(0));
+	case(FIELD_ADVECTION_Y) : return float(column.getAdvection(_statRequest)(1));
+	case(FIELD_BACK_RADIATION) : return float(column.getBackRadiation());
+	case(FIELD_ESCAPE_RADIATION) : return float(column.getEscapeRadiation());
+	}
+	return std::numeric_limits<float>::quiet_NaN();
+}
+
+//======================================
+//OUTPUT
+//======================================
+
+FieldOutput::FieldOutput(const std::string &prefix, const std::vector<FieldSpec> &fields, int framesPerChunk) noexcept :
+_prefix(prefix),
+_fields(fields),
+_framesPerChunk(std::max(framesPerChunk, 1))
+{
+	_writer = std::thread(&FieldOutput::writerLoop, this);
+}
+
+FieldOutput::~FieldOutput() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_frameReady.notify_one();
+	_writer.join();
+}
+
+void FieldOutput::capture(const World &world) noexcept
+{
+	const std::vector<Tile> &tiles = world.getTiles();
+
+	Frame frame;
+	frame.hour = int(my::SimulationTime::_globalTime.getTotalHours());
+	frame.values.reserve(_fields.size() * tiles.size());
+
+	for (const FieldSpec &field : _fields) {
+		for (const Tile &tile : tiles) {
+			frame.values.push_back(field.sample(tile._tileClimate));
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (int(_queue.size()) >= kMaxQueuedFrames) {
+			LOG("Field output behind, dropped hour " << frame.hour);
+			return;
+		}
+		_queue.push_back(std::move(frame));
+	}
+	_frameReady.notify_one();
+}
+
+void FieldOutput::writerLoop() noexcept
+{
+	while (true) {
+		Frame frame;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_frameReady.wait(lock, [this] { return _quit || !_queue.empty(); });
+			if (_queue.empty()) return;//quit, and nothing left to write
+
+			frame = std::move(_queue.front());
+			_queue.pop_front();
+		}
+
+		if (!_failed) writeFrame(frame);
+	}
+}
+
+void FieldOutput::writeFrame(const Frame &frame) noexcept
+{
+	int tileCount = _fields.empty() ? 0 : int(frame.values.size() / _fields.size());
+
+	if (!_index.is_open()) {
+		_index.open(_prefix + ".index");
+		if (!_index) { LOG("Could not open " << _prefix << ".index"); _failed = true; return; }
+		writeIndexHeader(tileCount);
+	}
+
+	if (!_chunk.is_open() || _framesInChunk == _framesPerChunk) {
+		if (!startChunk()) { _failed = true; return; }
+	}
+
+	//XOR delta against the previous frame, byte shuffled so the unchanged high bytes form long zero runs
+	size_t count = frame.values.size();
+	std::vector<uint8_t> shuffled(count * 4);
+	_previous.resize(count, 0);
+
+	for (size_t i = 0; i < count; i++) {
+		uint32_t bits;
+		std::memcpy(&bits, &frame.values[i], 4);
+
+		uint32_t delta = bits ^ _previous[i];
+		_previous[i] = bits;
+
+		for (int byte = 0; byte < 4; byte++) {
+			shuffled[byte*count + i] = uint8_t(delta >> (8 * byte));
+		}
+	}
+
+	std::vector<uint8_t> encoded;
+	zeroRunEncode(shuffled, encoded);
+
+	_chunk.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+	_chunk.flush();
+	if (!_chunk) { LOG("Could not write field chunk " << _chunkNumber); _failed = true; return; }
+
+	_index << frame.hour << " " << _chunkNumber << " " << _chunkOffset << " " << encoded.size() << "\n";
+	_index.flush();
+
+	_chunkOffset += encoded.size();
+	_framesInChunk++;
+}
+
+bool FieldOutput::startChunk() noexcept
+{
+	_chunk.close();
+	_chunkNumber++;
+	_framesInChunk = 0;
+	_chunkOffset = 0;
+	_previous.assign(_previous.size(), 0);//chunk starts from a key frame
+
+	std::stringstream path;
+	path << _prefix << "." << _chunkNumber << ".fields";
+
+	_chunk.open(path.str(), std::ios::binary);
+	if (!_chunk) { LOG("Could not open " << path.str()); return false; }
+	return true;
+}
+
+void FieldOutput::writeIndexHeader(int tileCount) noexcept
+{
+	_index << "pleistocene-fields 1\n";
+	_index << "rows " << my::Address::GetRows() << " cols " << my::Address::GetCols() << " tiles " << tileCount << "\n";
+	_index << "frames-per-chunk " << _framesPerChunk << "\n";
+	_index << "fields " << _fields.size();
+	for (const FieldSpec &field : _fields) {
+		_index << " " << field._name;
+	}
+	_index << "\n";
+	_index << "hour chunk offset bytes\n";
+}
+
+void FieldOutput::zeroRunEncode(const std::vector<uint8_t> &bytes, std::vector<uint8_t> &encoded) noexcept
+{
+	auto writeCount = [&encoded](size_t count) {
+		do {
+			uint8_t byte = count & 0x7F;
+			count >>= 7;
+			encoded.push_back(count ? (byte | 0x80) : byte);
+		} while (count);
+	};
+
+	size_t i = 0;
+	while (i < bytes.size()) {
+		size_t zeroStart = i;
+		while (i < bytes.size() && bytes[i] == 0) i++;
+		size_t zeros = i - zeroStart;
+
+		//literals run until the next pair of zeros (a lone zero is cheaper kept as a literal)
+		size_t literalStart = i;
+		while (i < bytes.size() && !(bytes[i] == 0 && i + 1 < bytes.size() && bytes[i + 1] == 0)) i++;
+		size_t literals = i - literalStart;
+
+		writeCount(zeros);
+		writeCount(literals);
+		encoded.insert(encoded.end(), bytes.begin() + literalStart, bytes.begin() + i);
+	}
+}
+
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,91 @@
+#pragma once
+#include "globals.h"
+#include "world.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <cstdint>
+
+namespace pleistocene {
+namespace simulation {
+
+enum FieldQuantity {
+	FIELD_STATISTIC,	//MaterialColumn::getStatistic (elevation, temperature, material, pressure anomaly, flow)
+	FIELD_ADVECTION_X,	//MaterialColumn::getAdvection
+	FIELD_ADVECTION_Y,
+	FIELD_BACK_RADIATION,	//infrared returned to the surface
+	FIELD_ESCAPE_RADIATION	//infrared lost to space
+};
+
+//One per-tile value streamed by FieldOutput, named like "temperature:air:0"
+struct FieldSpec {
+	std::string _name;
+	FieldQuantity _quantity = FIELD_STATISTIC;
+	StatRequest _statRequest;
+
+	//<quantity>[:<section>[:<layer>]]
+	//quantity: elevation, temperature, material, pressure, flow, advection-x, advection-y, back-radiation, escape-radiation
+	//section: surface (default), horizon, earth, sea, air. layer numbering as in the stat display
+	static bool parse(const std::string &text, FieldSpec &field) noexcept;
+
+	//NaN where the tile has no such layer
+	float sample(const climate::TileClimate &tileClimate) const noexcept;
+};
+
+//Streams fields to chunked, compressed binary files every time capture() is called, for offline analysis.
+//
+//capture() samples on the simulation thread (between hours) and queues the frame; a writer thread does the encoding and disk I/O.
+//Files: <prefix>.index (text: header, then one "hour chunk offset bytes" line per frame) and <prefix>.<chunk>.fields.
+//A frame is float32 values, field-major in tile index order, XORed with the chunk's previous frame (zeros for a chunk's first frame,
+//so chunks decode independently), byte-shuffled (all byte 0s, then byte 1s...) and zero-run encoded as repeated
+//[LEB128 zero count][LEB128 literal count][literal bytes].
+class FieldOutput {
+public:
+	FieldOutput(const std::string &prefix, const std::vector<FieldSpec> &fields, int framesPerChunk = 24) noexcept;
+	~FieldOutput() noexcept;//writes out everything still queued
+
+	FieldOutput(const FieldOutput &) = delete;
+	FieldOutput &operator=(const FieldOutput &) = delete;
+
+	//never waits on disk. if the writer falls too far behind the frame is dropped (and logged)
+	void capture(const World &world) noexcept;
+
+private:
+	struct Frame {
+		int hour;
+		std::vector<float> values;
+	};
+
+	static const int kMaxQueuedFrames = 64;
+
+	std::string _prefix;
+	std::vector<FieldSpec> _fields;
+	int _framesPerChunk;
+
+	//shared with the writer thread
+	std::mutex _mutex;
+	std::condition_variable _frameReady;
+	std::deque<Frame> _queue;
+	bool _quit = false;
+
+	//writer thread only
+	std::thread _writer;
+	std::ofstream _index;
+	std::ofstream _chunk;
+	int _chunkNumber = -1;
+	int _framesInChunk = 0;
+	uint64_t _chunkOffset = 0;
+	std::vector<uint32_t> _previous;
+	bool _failed = false;
+
+	void writerLoop() noexcept;
+	void writeFrame(const Frame &frame) noexcept;
+	bool startChunk() noexcept;
+	void writeIndexHeader(int tileCount) noexcept;
+
+	static void zeroRunEncode(const std::vector<uint8_t> &bytes, std::vector<uint8_t> &encoded) noexcept;
+};
+
+}//namespace simulation
+}//namespace pleistocene
@@ -1,6 +1,9 @@
 #include "game-options.h"
 #include "globals.h"
+#include <thread>
+#ifndef PLEISTOCENE_HEADLESS
 #include "input.h"
+#endif
 
 namespace pleistocene {
 namespace options {
@@ -8,6 +11,8 @@ namespace options {
 GameOptions::GameOptions() noexcept {
 	setWorldSize(2);
 	my::Address::getOptions(*this);
+
+	_simulationThreads = std::max(1, int(std::thread::hardware_concurrency()));
 }
 
 int GameOptions::getRows() const noexcept { return _rows; }
@@ -41,12 +46,19 @@ void GameOptions::setWorldSize(int sizeOption) noexcept {
 	my::Address::getOptions(*this);
 }
 
-void GameOptions::processInput(Input &input) {
+void GameOptions::setWorldDimensions(int rows, int cols) noexcept {
+	_rows = rows;
+	_cols = cols;
+	my::Address::getOptions(*this);
+}
+
+#ifndef PLEISTOCENE_HEADLESS
+void GameOptions::processInput(Input &input, int displayedHour) {
 
 	//toggle low frequency redraw
 	if (input.wasKeyPressed(SDL_SCANCODE_TAB)) {
 		_dailyDraw = !_dailyDraw;
-		_drawHour = my::SimulationTime::_globalTime.getHour();
+		_drawHour = displayedHour;
 	}
 
 	//toggle solar shading
@@ -55,8 +67,23 @@ void GameOptions::processInput(Input &input) {
 	//play/pause toggle
 	if (input.wasKeyPressed(SDL_SCANCODE_SPACE)) _continuousSimulation = !_continuousSimulation;
 
+	//parallel/serial simulation toggle
+	if (input.wasKeyPressed(SDL_SCANCODE_P)) {
+		_parallelSimulation = !_parallelSimulation;
+		if (_parallelSimulation) { LOG("Parallel simulation (" << _simulationThreads << " threads)"); }
+		else { LOG("Serial simulation"); }
+	}
+
+	//climate store/object path toggle
+	if (input.wasKeyPressed(SDL_SCANCODE_L)) {
+		_climateStore = !_climateStore;
+		if (_climateStore) { LOG("Climate store layout"); }
+		else { LOG("Object layout"); }
+	}
+
 	
 }
+#endif
 
 }//namespace options
 }//namespace pleistocene
\ No newline at end of file
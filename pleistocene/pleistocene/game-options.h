@@ -12,6 +12,8 @@ public:
 	GameOptions() noexcept;
 
 	void setWorldSize(int sizeOption) noexcept;
+	//exact dimensions (e.g. those of a loaded snapshot)
+	void setWorldDimensions(int rows, int cols) noexcept;
 
 	int getRows() const noexcept;
 	int getCols() const noexcept;
@@ -25,9 +27,36 @@ public:
 
 	bool _sunlit = true;
 
-	void processInput(Input &input);
+	//displayedHour: the hour on screen, which daily draw keeps redrawing
+	void processInput(Input &input, int displayedHour);
 
 	bool _continuousSimulation=false;
+
+	//elevation noise seed for the first world (new worlds from G are random)
+	double _worldSeed = 32360;
+
+	//split simulation steps across worker threads (neighbor-writing steps by tile color class).
+	//serial is kept as the reference order
+	bool _parallelSimulation = true;
+	int _simulationThreads;
+
+	//run radiation and conduction on the structure-of-arrays ClimateStore (bit-identical to the object path)
+	bool _climateStore = true;
+
+	//simulated hours per World::simulate (callers advance SimulationTime by as many). steps longer than an hour need _implicitRadiation
+	int _stepHours = 1;
+	bool _implicitRadiation = false;
+	//conduction up each column as one implicit (tridiagonal) solve, side surfaces pairwise. off: every surface pairwise (the reference)
+	bool _implicitVerticalConduction = false;
+	//air flow as two phases, every surface flux from the step's starting state then each layer's gather (AirFlowExchange).
+	//tile-local and order independent, so no colored sweep. off: surfaces transfer in turn (the reference)
+	bool _twoPhaseAirFlow = false;
+	//sunlight and infrared through the vectorized RadiationKernels, all columns level by level (needs _climateStore).
+	//a few ulp from the Mixture path in emission and equilibrium temperature, so off for the bit-identical reference
+	bool _batchedRadiation = false;
+	//sunlight from one sun vector per hour of the year instead of a per tile table (SolarRadiation::buildInsolationTable).
+	//kilobytes instead of tiles*11 KB, a few ulp from the reference
+	bool _lightInsolation = false;
 private:
 
 	int _rows;
@@ -1,4 +1,5 @@
 #include "game.h"
+#include "profiler.h"
 namespace pleistocene {
 
 Game::Game() noexcept :
@@ -8,10 +9,11 @@ _input(Input()),
 _infoBar(user_interface::InfoBar(_graphics)),
 _bios(user_interface::Bios(_graphics)),
 _camera(graphics::Camera(my::Vector2(0, 0), pow(.8, 10), _options)),
-_world(simulation::World(_graphics, _options))
+_world(_graphics, _options)
 {
 	initialize();
 	gameLoop();
+	my::Profiler::dump(kProfilePath);
 }
 
 void Game::initialize() noexcept 
@@ -22,6 +24,7 @@ void Game::initialize() noexcept
 	_input.setCamera(_camera);
 
 	_world.simulate(_options);//one initial call to simulate for graphical setup
+	_world.startSimulationThread(_options);//from here on the world simulates on its own thread
 	_world.draw(_graphics, true, _options, _bios);//one guaranteed call checking draw positions
 	_lastUpdateTime_MS = SDL_GetTicks();
 
@@ -36,8 +39,14 @@ void Game::gameLoop()  noexcept
 	while (!_quitFlag) {
 		_input.beginNewFrame();//Sorts input events into callable information
 		determineElapsedTime();		
-		processInput();	
-		update();
+		{
+			my::ScopedTimer timer("frame input");
+			processInput();
+		}
+		{
+			my::ScopedTimer timer("frame update");
+			update();
+		}
 		draw();
 	}
 }
@@ -70,13 +79,15 @@ void Game::processInput() noexcept
 		return;
 	}
 
+	if (_input.wasKeyPressed(SDL_SCANCODE_F3)) { _bios.toggleProfile(); }
+
 	//Process commands returns true if there is any camera movement
 	if (_camera.processCommands(_input, _elapsedTime_MS, _options)) {
 		_cameraMovementFlag = true;
 	}
 	 
 	// Update options
-	_options.processInput(_input);
+	_options.processInput(_input, _world.getDisplayedHour());
 
 	_world.processInput(_input, _options);
 
@@ -93,26 +104,31 @@ void Game::processInput() noexcept
 void Game::update()  noexcept 
 {
 	_bios.update(_world.getMessages());
-	_infoBar.update(_world.getReadout());
+	_infoBar.update(_world.getTimeReadout(), _world.getReadout());
 }
 
 
 void Game::draw()  noexcept 
 {
-
-	//Low/High framerate control
-	if ((!_options._dailyDraw) ||							//draw each hour if daily draw off
-		_graphics._selecting ||							//draw whenever user clicks on a tile
-		my::SimulationTime::_globalTime.getHour() == _options._drawHour ||	//draw on specified draw hour
-		_cameraMovementFlag)							//draw when camera moves
 	{
-		_graphics.clear();
-		_world.draw(_graphics, _cameraMovementFlag, _options, _bios);
-		_cameraMovementFlag = false;//i.e. processed
+		my::ScopedTimer timer("frame draw");
+
+		//Low/High framerate control
+		if ((!_options._dailyDraw) ||							//draw each hour if daily draw off
+			_graphics._selecting ||							//draw whenever user clicks on a tile
+			_world.getDisplayedHour() == _options._drawHour ||	//draw on specified draw hour
+			_cameraMovementFlag)							//draw when camera moves
+		{
+			_graphics.clear();
+			_world.draw(_graphics, _cameraMovementFlag, _options, _bios);
+			_cameraMovementFlag = false;//i.e. processed
+		}
+
+		_infoBar.draw(_graphics);
+		_bios.draw(_graphics);
 	}
 
-	_infoBar.draw(_graphics);
-	_bios.draw(_graphics);
+	my::ScopedTimer timer("frame flip");
 	_graphics.flip();
 }
 
@@ -8,6 +8,10 @@
 #include "camera.h"
 
 namespace pleistocene {
+
+//section timings are written here on exit (see my::Profiler)
+const std::string kProfilePath = "profile.txt";
+
 /*
 Game
 
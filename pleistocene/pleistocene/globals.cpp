@@ -1,6 +1,7 @@
 #include "globals.h"
 #include "game-options.h"
 #include "tile-climate.h"
+#include "checkpoint.h"
 namespace pleistocene {
 namespace my {
 Vector2::Vector2(Vector2d v2) noexcept {
@@ -21,6 +22,7 @@ Rectangle::~Rectangle() noexcept {}
 Rectangle::Rectangle(int x, int y, int w, int h) noexcept :
 x(x), y(y), w(w), h(h) {}
 
+#ifndef PLEISTOCENE_HEADLESS
 Rectangle::Rectangle(SDL_Rect rect) noexcept :
 	x(rect.x), y(rect.y), w(rect.w), h(rect.h) {}
 
@@ -49,6 +51,7 @@ const SDL_Rect Rectangle::cameraTransform(const double SCALE, const Vector2 C) c
 	GameRect.y -= C.y;
 	return GameRect;
 }
+#endif
 
 
 void Rectangle::moveRect(const Vector2 &S) noexcept {
@@ -240,6 +243,13 @@ void SimulationTime::updateGlobalTime() noexcept
 	}
 }
 
+void SimulationTime::updateGlobalTime(int hours) noexcept
+{
+	for (int hour = 0; hour < hours; hour++) {
+		updateGlobalTime();
+	}
+}
+
 void SimulationTime::resetGlobalTime() noexcept
 {
 	_globalTime._day = 0;
@@ -248,6 +258,20 @@ void SimulationTime::resetGlobalTime() noexcept
 	//TODO ensure any created simulation time objects are destroyed when resetGlobalTime is called (at new world creation only?)
 }
 
+void SimulationTime::writeSnapshot(SnapshotWriter &writer) noexcept
+{
+	writer.write(_globalTime._year);
+	writer.write(_globalTime._day);
+	writer.write(_globalTime._hour);
+}
+
+void SimulationTime::readSnapshot(SnapshotReader &reader) noexcept
+{
+	reader.read(_globalTime._year);
+	reader.read(_globalTime._day);
+	reader.read(_globalTime._hour);
+}
+
 std::vector<std::string> SimulationTime::readGlobalTime() noexcept 
 {
 
@@ -361,9 +385,33 @@ double radToDeg(double rad) noexcept
 }
 
 
-double uniformRandom() noexcept
+//splitmix64
+namespace {
+uint64_t mixBits(uint64_t bits) noexcept
+{
+	bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ull;
+	bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBull;
+	return bits ^ (bits >> 31);
+}
+
+const uint64_t kGoldenGamma = 0x9E3779B97F4A7C15ull;
+}
+
+CounterRandom::CounterRandom() noexcept {}
+
+CounterRandom::CounterRandom(uint64_t seed) noexcept : _key(seed) {}
+
+CounterRandom CounterRandom::stream(uint64_t index) const noexcept
+{
+	CounterRandom child;
+	child._key = mixBits(_key * kGoldenGamma + index);
+	return child;
+}
+
+double CounterRandom::uniform() noexcept
 {
-	return double(rand()) / double(RAND_MAX + 1.0);
+	uint64_t bits = mixBits((_key + _draw++) * kGoldenGamma);
+	return double(bits >> 11) / double(1ull << 53);
 }
 
 
@@ -2,8 +2,10 @@
 
 #define DEBUG 1
 
+//PLEISTOCENE_HEADLESS builds the simulation without SDL or any rendering (see CMakeLists.txt, pleistocene-sim)
+
 //Strings and such
-#if DEBUG
+#if DEBUG && defined(_WIN32)
 #define NOMINMAX	//fuck off windows.h
 #include <Windows.h>
 #endif
@@ -22,12 +24,15 @@
 //Math
 #include "math.h"	//pow, trig functions
 #include <stdlib.h>	//srand, rand
+#include <cstdint>	//uint64_t
 #include <time.h>	//time
 #include <Eigen/Dense>	//linear algebra
 
 //Graphics
+#ifndef PLEISTOCENE_HEADLESS
 #include "SDL.h"	//graphics engine
 #include "SDL_ttf.h"	//true type font
+#endif
 
 
 //LOG to console
@@ -37,14 +42,21 @@
 //#define LOG(x)
 //#endif
 
-//LOG to output window
-#if DEBUG
+//LOG to output window (stderr off windows)
+#if DEBUG && defined(_WIN32)
 #define LOG( s )				\
 {						\
 	std::ostringstream os_;			\
 	os_ << s << "\n";			\
 	OutputDebugString( os_.str().c_str() );	\
 }
+#elif DEBUG
+#define LOG( s )				\
+{						\
+	std::ostringstream os_;			\
+	os_ << s << "\n";			\
+	std::cerr << os_.str();			\
+}
 #else
 #define LOG(x)
 #endif
@@ -70,8 +82,6 @@ const int kMaxFrameTime = 5 * 1000 / kFPS;//cutoff frame time after 100 MS
 
 
 
-class options::GameOptions;
-
 namespace my {
 
 
@@ -80,7 +90,24 @@ const double kFakeDouble = -6666.0;
 const int kFakeInt = -6666;
 const int kFakeIndex = -6666;
 
-double uniformRandom() noexcept;
+//Counter-based random numbers for world generation. A draw is a hash of (seed, stream keys, draw index) and
+//never of earlier draws, so streams can be drawn from on any thread in any order and give the same values.
+//World keys them seed -> tile -> layer, so a seed always gives the same world
+class CounterRandom {
+public:
+	CounterRandom() noexcept;
+	explicit CounterRandom(uint64_t seed) noexcept;
+
+	//independent stream keyed by index, e.g. a tile, then a layer within it
+	CounterRandom stream(uint64_t index) const noexcept;
+
+	//from 0 to 1, draw by draw
+	double uniform() noexcept;
+
+private:
+	uint64_t _key = 0;
+	uint64_t _draw = 0;
+};
 
 enum Direction {
 	NORTH_EAST,
@@ -103,7 +130,9 @@ public:
 	Vector2() { x = 0; y = 0; }
 	Vector2(int X, int Y) { x = X; y = Y; }
 	Vector2(Vector2d v2) noexcept;
+#ifndef PLEISTOCENE_HEADLESS
 	Vector2(SDL_Point P) { x = P.x; y = P.y; }
+#endif
 
 
 	//Addition overload
@@ -218,11 +247,13 @@ public:
 	Rectangle() noexcept;
 	~Rectangle() noexcept;
 	Rectangle(int x, int y, int w, int h) noexcept;
+#ifndef PLEISTOCENE_HEADLESS
 	Rectangle(SDL_Rect rect) noexcept;
 
 	SDL_Rect getSDL_Rect() const noexcept;
 
 	const SDL_Rect cameraTransform(const double SCALE, const Vector2 _c) const noexcept;
+#endif
 
 	const Vector2 getCenter() const noexcept;
 
@@ -290,6 +321,9 @@ public:
 };
 
 
+class SnapshotWriter;
+class SnapshotReader;
+
 //This class is kinda stupid
 class SimulationTime {
 public:
@@ -300,10 +334,15 @@ public:
 	static SimulationTime _globalTime;
 
 	static void updateGlobalTime() noexcept;
+	static void updateGlobalTime(int hours) noexcept;
 	static void resetGlobalTime() noexcept;
 
 	static std::vector<std::string> readGlobalTime() noexcept;
 
+	//global time in world snapshots
+	static void writeSnapshot(SnapshotWriter &writer) noexcept;
+	static void readSnapshot(SnapshotReader &reader) noexcept;
+
 	double getTotalYears() const noexcept;
 	double getTotalDays() const noexcept;
 	double getTotalHours() const noexcept;
@@ -2,6 +2,6 @@
 
 int main(int argc, char* args[]) noexcept 
 {
-	pleistocene::Game game = pleistocene::Game();
+	pleistocene::Game game;
 	return 0;
 }
@@ -1,6 +1,7 @@
 #include "material-column.h"
 #include "tile-climate.h"
 #include "world.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -13,14 +14,27 @@ namespace layers {
 
 MaterialColumn::MaterialColumn()  noexcept {}
 
-MaterialColumn::MaterialColumn(double landElevation, double initialTemperature) noexcept :
-_landElevation(landElevation),
-_initialTemperature(initialTemperature),
-_submerged(_landElevation < -2)
+void MaterialColumn::generate(double landElevation, double initialTemperature, my::CounterRandom random) noexcept
 {
-	double baseElevation = buildEarth();
+	_landElevation = landElevation;
+	_initialTemperature = initialTemperature;
+	_submerged = (_landElevation < -2);
 
-	baseElevation = buildHorizon(baseElevation);
+	_earth.clear();
+	_horizon.clear();
+	_sea.clear();
+	_air.clear();
+	_neighbors = nullptr;
+	_columns = nullptr;
+
+	_earth.reserve(layers::earth::earthLayers);
+	_horizon.reserve(1);
+	_sea.reserve(layers::sea::kMaxSeaLayers);
+	_air.reserve(layers::air::kMaxAirLayers);
+
+	double baseElevation = buildEarth(random);
+
+	baseElevation = buildHorizon(baseElevation, random);
 
 	if (_submerged) {//TODO. sand bars? reefs? marshes? lagoons?
 		baseElevation = buildSea(baseElevation, 0);
@@ -33,7 +47,7 @@ _submerged(_landElevation < -2)
 
 //Layer Builders
 //================
-double MaterialColumn::buildEarth() noexcept
+double MaterialColumn::buildEarth(const my::CounterRandom &random) noexcept
 {
 	using namespace layers::earth;
 
@@ -43,15 +57,16 @@ double MaterialColumn::buildEarth() noexcept
 	for (int i = 0; i < earthLayers; i++) {
 		double layerHeight = earthLayerHeights[i];
 		//_earth.emplace_back(bedrockElevation, 280, currentElevation, layerHeight);
-		_earth.emplace_back(bedrockElevation, _initialTemperature, currentElevation, layerHeight, false);
+		_earth.emplace_back(bedrockElevation, _initialTemperature, currentElevation, layerHeight, false, random.stream(i));
 		currentElevation = _earth.back().getTopElevation();
 	}
 	return currentElevation;
 }
 
-double MaterialColumn::buildHorizon(double baseElevation) noexcept
+double MaterialColumn::buildHorizon(double baseElevation, const my::CounterRandom &random) noexcept
 {
-	_horizon.emplace_back(_landElevation - earth::bedrockDepth, _initialTemperature, baseElevation, !_submerged);
+	_horizon.emplace_back(_landElevation - earth::bedrockDepth, _initialTemperature, baseElevation, !_submerged,
+		random.stream(earth::earthLayers));
 	double currentElevation = _horizon.back().getTopElevation();
 	return currentElevation;
 }
@@ -95,12 +110,9 @@ void MaterialColumn::buildAir(double baseElevation) noexcept
 	double layerBottomElevation = baseElevation;
 	double layerTopElevation = layerBottomElevation + boundaryLayerHeight;
 
-	AirLayer buildLayer;
-
 	//build boundary layer
-	buildLayer = AirLayer(baseElevation, _initialTemperature, layerBottomElevation, layerTopElevation);
-	//buildLayer = AirLayer(baseElevation, 288, layerBottomElevation, layerTopElevation);
-	_air.push_back(std::move(buildLayer));
+	_air.emplace_back(baseElevation, _initialTemperature, layerBottomElevation, layerTopElevation);
+	//_air.emplace_back(baseElevation, 288, layerBottomElevation, layerTopElevation);
 	layerBottomElevation = layerTopElevation;
 
 	int i = 0;
@@ -108,9 +120,8 @@ void MaterialColumn::buildAir(double baseElevation) noexcept
 
 	for (; i < 6; i++) {
 		layerTopElevation = airElevations[i];
-		//buildLayer = AirLayer(baseElevation, _initialTemperature, layerBottomElevation, layerTopElevation);
-		buildLayer = AirLayer(baseElevation, 288, layerBottomElevation, layerTopElevation);
-		_air.push_back(std::move(buildLayer));
+		//_air.emplace_back(baseElevation, _initialTemperature, layerBottomElevation, layerTopElevation);
+		_air.emplace_back(baseElevation, 288, layerBottomElevation, layerTopElevation);
 		layerBottomElevation = layerTopElevation;
 	}
 }
@@ -122,6 +133,7 @@ void MaterialColumn::buildUniversalColumn() noexcept
 {
 
 	_column.clear();
+	_column.reserve(_earth.size() + _horizon.size() + _sea.size() + _air.size());
 	for (auto &layer : _earth) {
 		_column.push_back(&layer);
 	}
@@ -147,9 +159,9 @@ void MaterialColumn::buildUniversalColumn() noexcept
 
 }
 
-void MaterialColumn::buildAdjacency(std::map<my::Direction, MaterialColumn*> &adjacientColumns) noexcept
+void MaterialColumn::buildAdjacency(const NeighborGraph &graph, int tile, const std::vector<MaterialColumn*> &columns) noexcept
 {
-	_adjacientColumns = adjacientColumns;
+	linkAdjacency(graph, tile, columns);
 
 	buildTopSurfaces();
 
@@ -157,13 +169,25 @@ void MaterialColumn::buildAdjacency(std::map<my::Direction, MaterialColumn*> &ad
 
 }
 
+void MaterialColumn::linkAdjacency(const NeighborGraph &graph, int tile, const std::vector<MaterialColumn*> &columns) noexcept
+{
+	_neighbors = graph.getNeighbors(tile);
+	_columns = columns.data();
+}
+
+MaterialColumn *MaterialColumn::getNeighborColumn(my::Direction direction) const noexcept
+{
+	int32_t neighbor = _neighbors[direction];
+	return neighbor == NeighborGraph::kNoNeighbor ? nullptr : _columns[neighbor];
+}
+
 //Surface Builders
 //=================
 
 void MaterialColumn::buildNeighborSurfaces() noexcept
 {
 	for (my::Direction ownedDirection : ownedDirections) {
-		if (this->_adjacientColumns.count(ownedDirection)) {
+		if (_neighbors[ownedDirection] != NeighborGraph::kNoNeighbor) {
 			buildGeneralNeighborSurfaces(ownedDirection);
 			buildAirSurfaces(ownedDirection);
 			buildEarthSurfaces(ownedDirection);
@@ -207,7 +231,7 @@ void MaterialColumn::buildGeneralNeighborSurfaces(my::Direction ownedDirection)
 	SharedSurface surface;
 
 	MaterialLayer *A = _column.front();//this column's layer
-	MaterialLayer *B = _adjacientColumns[ownedDirection]->_column.front();//neighbor column's layer
+	MaterialLayer *B = getNeighborColumn(ownedDirection)->_column.front();//neighbor column's layer
 
 	double A_bot, A_top, B_bot, B_top;
 	double top, bot;
@@ -281,7 +305,8 @@ void MaterialColumn::buildAirSurfaces(my::Direction ownedDirection) noexcept
 	SharedSurface buildSurface;
 
 	auto A = _air.begin();//this column's layer
-	auto B = _adjacientColumns[ownedDirection]->_air.begin();//neighbor column's layer
+	MaterialColumn *neighbor = getNeighborColumn(ownedDirection);
+	auto B = neighbor->_air.begin();//neighbor column's layer
 
 	double A_bot, A_top, B_bot, B_top;
 	double top, bot;
@@ -310,7 +335,7 @@ void MaterialColumn::buildAirSurfaces(my::Direction ownedDirection) noexcept
 
 			}
 			B++;
-			if (B == _adjacientColumns[ownedDirection]->_air.end()) { return; }
+			if (B == neighbor->_air.end()) { return; }
 		}
 		else { //B above
 			if (A_top > B_bot) {//in contact
@@ -361,9 +386,18 @@ void MaterialColumn::beginNewHour() noexcept {
 
 }
 
+//top of the column downward
 void MaterialColumn::filterSolarRadiation(double energyKJ) noexcept
 {
-	_column.back()->filterSolarRadiation(energyKJ);
+	for (int k = int(_column.size()) - 1; k >= 0; k--) {
+		energyKJ = _column[k]->filterSolarRadiation(energyKJ);
+
+		//don't send down less than a joule
+		if (energyKJ <= 0.001) return;
+
+		//the sunlight has reached the abyss and you have bigger problems
+		if (k == 0) { LOG("Sun to bedrock?"); exit(EXIT_FAILURE); }
+	}
 }
 
 void MaterialColumn::simulateEvaporation() noexcept
@@ -373,51 +407,95 @@ void MaterialColumn::simulateEvaporation() noexcept
 
 void MaterialColumn::simulateInfraredRadiation() noexcept
 {
-	MaterialLayer* surfaceLayer;
-
 	//surface radiation
-	if (_submerged) { surfaceLayer = &_sea.back(); }
-	else { surfaceLayer = &_horizon.back(); }
+	MaterialLayer* surfaceLayer = getSurfaceLayer();
 
 
 	double upRadiation;//radiation incident upwards upon layer
 	double emittedEnergy;
-	std::vector<double> downRadiation;//radiation incident downwards upon layer
+	double downRadiation[air::kMaxAirLayers];//radiation incident downwards upon layer
+
+	int airLayers = int(_air.size());
+	if (airLayers == 0 || airLayers > air::kMaxAirLayers) { LOG("Unexpected air layer count"); exit(EXIT_FAILURE); }
 
-	double fraction = 1.0;
-	
 	upRadiation = surfaceLayer->emitInfraredRadiation();
-	downRadiation.clear();
 
 	//filter/emit upwards
-	for (AirLayer &air : _air) {
-		upRadiation = air.filterInfraredRadiation(upRadiation);
-		emittedEnergy = air.emitInfraredRadiation();
-		downRadiation.push_back(emittedEnergy / 2.0);
+	for (int j = 0; j < airLayers; j++) {
+		upRadiation = _air[j].filterInfraredRadiation(upRadiation);
+		emittedEnergy = _air[j].emitInfraredRadiation();
+		downRadiation[j] = emittedEnergy / 2.0;
 		upRadiation+= emittedEnergy / 2.0;
 	}
 	_escapeRadiation = upRadiation;
 
-
-	double currentDownRadiation;
-	auto radiation_rit = downRadiation.rbegin();//end of down radiation vector
-	
 	//filter downwards
-	for (auto air_rit = _air.rbegin() + 1; air_rit != _air.rend(); ++air_rit) {
-		currentDownRadiation = *radiation_rit;
-		++radiation_rit;//advance down radiation reverse iterator
-		*radiation_rit += air_rit->filterInfraredRadiation(currentDownRadiation);//filter radiation
+	for (int j = airLayers - 2; j >= 0; j--) {
+		downRadiation[j] += _air[j].filterInfraredRadiation(downRadiation[j + 1]);
 	}
-		
-	_backRadiation = *radiation_rit;
 
-	surfaceLayer->filterInfraredRadiation(*radiation_rit);
+	_backRadiation = downRadiation[0];
+
+	surfaceLayer->filterInfraredRadiation(downRadiation[0]);
 }
 
 void MaterialColumn::simulateConduction() noexcept{
+	bool includeVertical = (TileClimate::getConductionScheme() == PAIRWISE_CONDUCTION);
 	for (MaterialLayer *layer : _column) {
-		layer->simulateConduction();
+		layer->simulateConduction(includeVertical);
+	}
+}
+
+//Backward Euler over the column, g_k being the conductance of layer k's top surface over the step:
+//C_k T'_k = C_k T_k + g_(k-1) (T'_(k-1) - T'_k) + g_k (T'_(k+1) - T'_k)
+//The system is tridiagonal and diagonally dominant, so one Thomas sweep up the column and one back down solve it,
+//and no exchange can overshoot whatever the step length. ClimateStore::solveVerticalConduction has the same arithmetic.
+void MaterialColumn::simulateVerticalConduction() noexcept
+{
+	int levels = int(_column.size());
+	double stepHours = TileClimate::getStepHours();
+
+	std::vector<double> cPrime(levels);
+	std::vector<double> dPrime(levels);
+
+	double belowConductance = 0;
+	double belowCPrime = 0;
+	double belowDPrime = 0;
+
+	for (int level = 0; level < levels; level++) {
+		const elements::Mixture &mixture = *_column[level]->getMixture();
+		double capacity = mixture.getHeatCapacity();
+		double aboveConductance = topConductance(level)*stepHours;
+
+		double pivot = capacity + belowConductance + aboveConductance + belowConductance*belowCPrime;
+		cPrime[level] = -aboveConductance / pivot;
+		dPrime[level] = (capacity*mixture.getTemperature() + belowConductance*belowDPrime) / pivot;
+
+		belowConductance = aboveConductance;
+		belowCPrime = cPrime[level];
+		belowDPrime = dPrime[level];
+	}
+
+	double aboveTemperature = 0;
+	for (int level = levels - 1; level >= 0; level--) {
+		double temperature = dPrime[level] - cPrime[level] * aboveTemperature;
+		_column[level]->getMixture()->conductTo(temperature);
+		aboveTemperature = temperature;
+	}
+}
+
+double MaterialColumn::topConductance(int level) const noexcept
+{
+	if (level + 1 == int(_column.size())) return 0;
+
+	for (const SharedSurface &surface : _column[level]->getSharedSurfaces()) {
+		if (surface._spatialDirection != UP) continue;
+		if (surface.getTenant() != _column[level + 1]) { LOG("Top surface not shared with the layer above"); exit(EXIT_FAILURE); }
+
+		return elements::Mixture::conductivity(*surface.getTenant()->getMixture(), *surface.getOwner()->getMixture())*surface.getArea();
 	}
+
+	LOG("Layer without a top surface"); exit(EXIT_FAILURE);
 }
 
 void MaterialColumn::simulatePressure() noexcept
@@ -432,9 +510,11 @@ void MaterialColumn::simulatePressure() noexcept
 
 void MaterialColumn::simulateAirFlow()  noexcept 
 {
-	//FLOW
-	for (AirLayer &air : _air) {
-		air.simulateFlow();
+	//FLOW (TWO_PHASE_AIR_FLOW: already exchanged by the AirFlowExchange)
+	if (TileClimate::getAirFlowScheme() == SEQUENTIAL_AIR_FLOW) {
+		for (AirLayer &air : _air) {
+			air.simulateFlow();
+		}
 	}
 
 	//bottom boundary condition
@@ -448,7 +528,7 @@ void MaterialColumn::simulateAirFlow()  noexcept
 	_air.rbegin()->getGasPtr()->setInertia(stratInertia);
 
 	//polar filter?
-	if (_adjacientColumns.count(my::NORTH_EAST) == 0) {
+	if (_neighbors[my::NORTH_EAST] == NeighborGraph::kNoNeighbor) {
 		for (auto &air : _air) {
 			Eigen::Vector3d inertia = air.getGasPtr()->getInertia();
 			if (inertia[1] < 0) {
@@ -459,7 +539,7 @@ void MaterialColumn::simulateAirFlow()  noexcept
 	}
 
 	//antipolar filter
-	if (_adjacientColumns.count(my::SOUTH_EAST) == 0) {
+	if (_neighbors[my::SOUTH_EAST] == NeighborGraph::kNoNeighbor) {
 		for (auto &air : _air) {
 			Eigen::Vector3d inertia = air.getGasPtr()->getInertia();
 			if (inertia[1] > 0) {
@@ -483,11 +563,225 @@ void MaterialColumn::simulatePrecipitation() noexcept
 void MaterialColumn::simulateWaterFlow() noexcept {}
 void MaterialColumn::simulatePlants()  noexcept {}
 
+void MaterialColumn::setRadiationBudget(double backRadiation, double escapeRadiation) noexcept
+{
+	_backRadiation = backRadiation;
+	_escapeRadiation = escapeRadiation;
+}
+
+//==================================
+//CHECKPOINT
+//==================================
+
+namespace {
+
+template<typename Layer>
+void writeLayers(my::SnapshotWriter &writer, const std::vector<Layer> &layers) noexcept
+{
+	writer.write(int32_t(layers.size()));
+	for (const Layer &layer : layers) {
+		layer.writeSnapshot(writer);
+	}
+}
+
+template<typename Layer>
+void readLayers(my::SnapshotReader &reader, std::vector<Layer> &layers) noexcept
+{
+	layers.clear();
+	layers.resize(reader.read<int32_t>());
+	for (Layer &layer : layers) {
+		layer.readSnapshot(reader);
+	}
+}
+
+}//namespace
+
+void MaterialColumn::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_landElevation);
+	writer.write(_submerged);
+	writer.write(_initialTemperature);
+	writer.write(_escapeRadiation);
+	writer.write(_backRadiation);
+
+	writeLayers(writer, _earth);
+	writeLayers(writer, _horizon);
+	writeLayers(writer, _sea);
+	writeLayers(writer, _air);
+}
+
+void MaterialColumn::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	reader.read(_landElevation);
+	reader.read(_submerged);
+	reader.read(_initialTemperature);
+	reader.read(_escapeRadiation);
+	reader.read(_backRadiation);
+
+	readLayers(reader, _earth);
+	readLayers(reader, _horizon);
+	readLayers(reader, _sea);
+	readLayers(reader, _air);
+
+	buildUniversalColumn();
+}
+
+//earth, horizon and sea specific surfaces are never built yet, so only general and air surfaces are stored
+void MaterialColumn::writeSurfaceSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	for (const MaterialLayer *layer : _column) {
+		const std::vector<SharedSurface> &surfaces = layer->getSharedSurfaces();
+		writer.write(int32_t(surfaces.size()));
+		for (const SharedSurface &surface : surfaces) {
+			writeLayerReference(writer, surface.getOwner());
+			writeLayerReference(writer, surface.getTenant());
+			surface.writeSnapshot(writer);
+		}
+	}
+
+	for (const AirLayer &layer : _air) {
+		const std::vector<SharedAirSurface> &airSurfaces = layer.getSharedAirSurfaces();
+		writer.write(int32_t(airSurfaces.size()));
+		for (const SharedAirSurface &airSurface : airSurfaces) {
+			writeLayerReference(writer, airSurface.getOwner());
+			writeLayerReference(writer, airSurface.getTenant());
+			airSurface.writeSnapshot(writer);
+		}
+	}
+}
+
+void MaterialColumn::readSurfaceSnapshot(my::SnapshotReader &reader) noexcept
+{
+	SharedSurface surface;
+	MaterialLayer *owner;
+	MaterialLayer *tenant;
+
+	for (MaterialLayer *layer : _column) {
+		int32_t surfaceCount = reader.read<int32_t>();
+		for (int i = 0; i < surfaceCount; i++) {
+			owner = readLayerReference(reader);
+			tenant = readLayerReference(reader);
+			surface.readSnapshot(reader, owner, tenant);
+			layer->addSurface(surface);
+		}
+	}
+
+	SharedAirSurface airSurface;
+
+	for (AirLayer &layer : _air) {
+		int32_t surfaceCount = reader.read<int32_t>();
+		for (int i = 0; i < surfaceCount; i++) {
+			owner = readLayerReference(reader);
+			tenant = readLayerReference(reader);
+			if (owner->getType() != AIR || tenant->getType() != AIR) { LOG("Corrupt snapshot (air surface on a non-air layer)"); exit(EXIT_FAILURE); }
+
+			airSurface.readSnapshot(reader, static_cast<AirLayer*>(owner), static_cast<AirLayer*>(tenant));
+			layer.addAirSurface(airSurface);
+		}
+	}
+}
+
+void MaterialColumn::writeState(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_landElevation);
+	writer.write(_submerged);
+	writer.write(_initialTemperature);
+	writer.write(_escapeRadiation);
+	writer.write(_backRadiation);
+
+	writer.write(int32_t(_column.size()));
+	for (const MaterialLayer *layer : _column) {
+		layer->writeState(writer);
+		for (const SharedSurface &surface : layer->getSharedSurfaces()) {
+			surface.writeSnapshot(writer);
+		}
+	}
+
+	for (const AirLayer &layer : _air) {
+		for (const SharedAirSurface &airSurface : layer.getSharedAirSurfaces()) {
+			airSurface.writeSnapshot(writer);
+		}
+	}
+}
+
+void MaterialColumn::readState(my::SnapshotReader &reader) noexcept
+{
+	reader.read(_landElevation);
+	reader.read(_submerged);
+	reader.read(_initialTemperature);
+	reader.read(_escapeRadiation);
+	reader.read(_backRadiation);
+
+	if (reader.read<int32_t>() != int32_t(_column.size())) { LOG("Column state from a different layout"); exit(EXIT_FAILURE); }
+	for (MaterialLayer *layer : _column) {
+		layer->readState(reader);
+		for (SharedSurface &surface : layer->getSharedSurfaces()) {
+			surface.readSnapshot(reader, surface.getOwner(), surface.getTenant());
+		}
+	}
+
+	for (AirLayer &layer : _air) {
+		for (SharedAirSurface &airSurface : layer.getSharedAirSurfaces()) {
+			airSurface.readSnapshot(reader, static_cast<AirLayer*>(airSurface.getOwner()), static_cast<AirLayer*>(airSurface.getTenant()));
+		}
+	}
+}
+
+void MaterialColumn::writeLayerReference(my::SnapshotWriter &writer, const MaterialLayer *layer) const noexcept
+{
+	auto position = std::find(_column.begin(), _column.end(), layer);
+	if (position != _column.end()) {
+		writer.write(int32_t(kOwnColumn));
+		writer.write(int32_t(position - _column.begin()));
+		return;
+	}
+
+	for (int direction = 0; direction < NeighborGraph::kDirections; direction++) {
+		const MaterialColumn *neighbor = getNeighborColumn(my::Direction(direction));
+		if (neighbor == nullptr) continue;
+
+		const std::vector<MaterialLayer*> &column = neighbor->_column;
+		position = std::find(column.begin(), column.end(), layer);
+		if (position != column.end()) {
+			writer.write(int32_t(direction));
+			writer.write(int32_t(position - column.begin()));
+			return;
+		}
+	}
+
+	LOG("Surface layer not in this column or its neighbors"); exit(EXIT_FAILURE);
+}
+
+MaterialLayer *MaterialColumn::readLayerReference(my::SnapshotReader &reader) noexcept
+{
+	int32_t columnReference = reader.read<int32_t>();
+	int32_t position = reader.read<int32_t>();
+
+	MaterialColumn *column = this;
+	if (columnReference != kOwnColumn) {
+		if (columnReference < 0 || columnReference >= NeighborGraph::kDirections) { LOG("Corrupt snapshot (bad neighbor column)"); exit(EXIT_FAILURE); }
+		column = getNeighborColumn(my::Direction(columnReference));
+		if (column == nullptr) { LOG("Corrupt snapshot (missing neighbor column)"); exit(EXIT_FAILURE); }
+	}
+
+	if (position < 0 || position >= int(column->_column.size())) { LOG("Corrupt snapshot (layer out of range)"); exit(EXIT_FAILURE); }
+	return column->_column[position];
+}
+
 //==================================
 //GETTERS
 //==================================
 
 double MaterialColumn::getLandElevation() const noexcept { return _horizon.back().getTopElevation(); }
+
+const std::vector<MaterialLayer*> &MaterialColumn::getColumn() const noexcept { return _column; }
+
+MaterialLayer *MaterialColumn::getSurfaceLayer() noexcept
+{
+	if (_submerged) { return &_sea.back(); }
+	else { return &_horizon.back(); }
+}
+
 double MaterialColumn::getSurfaceTemperature()const noexcept
 {
 	if (_submerged) { return _sea.back().getTemperature(); }
@@ -496,6 +790,10 @@ double MaterialColumn::getSurfaceTemperature()const noexcept
 }
 double MaterialColumn::getBoundaryLayerTemperature() const noexcept { return _air.front().getTemperature(); }
 
+double MaterialColumn::getBackRadiation() const noexcept { return _backRadiation; }
+
+double MaterialColumn::getEscapeRadiation() const noexcept { return _escapeRadiation; }
+
 std::vector<std::string> MaterialColumn::getMessages(const StatRequest &statRequest) const noexcept
 {
 	std::vector<std::string> messages;
@@ -656,6 +954,8 @@ Eigen::Vector2d MaterialColumn::getAdvection(const StatRequest &statRequest) con
 {
 	chooseLayer(statRequest);//maybe redundant, but don't want to depend on previous call to set _chosenLayer
 
+	if (_chosenLayer == nullptr) return Eigen::Vector2d{ 0, 0 };//e.g. sea section of a land tile
+
 	return _chosenLayer->getAdvection();
 }
 
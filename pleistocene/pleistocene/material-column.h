@@ -3,6 +3,7 @@
 #include "material-layer.h"
 #include "state-mixture.h"
 #include "element.h"
+#include "neighbor-graph.h"
 
 namespace pleistocene {
 
@@ -34,28 +35,36 @@ class MaterialColumn {
 	double _escapeRadiation;
 	double _backRadiation;
 
-	std::map<my::Direction, MaterialColumn*> _adjacientColumns;
+	//neighbors: this column's slots in the world's NeighborGraph, and the world's columns by tile (see linkAdjacency)
+	const int32_t *_neighbors = nullptr;
+	MaterialColumn *const *_columns = nullptr;
+	MaterialColumn *getNeighborColumn(my::Direction direction) const noexcept;//nullptr at the grid's edge
 
 	//====================================================
 	//INITIALIZATION
 	//====================================================
 public:
 	MaterialColumn() noexcept;
-	MaterialColumn(double landElevation, double initialTemperature) noexcept;
+	//builds the layers in place, replacing any there were (and their surfaces, see buildAdjacency).
+	//random is the tile's stream, each earth layer draws its soil from its own substream of it
+	void generate(double landElevation, double initialTemperature, my::CounterRandom random) noexcept;
 
 
 private:
 	//layer builders
 	//================
-	double buildEarth() noexcept;
-	double buildHorizon(double baseElevation) noexcept;
+	double buildEarth(const my::CounterRandom &random) noexcept;
+	double buildHorizon(double baseElevation, const my::CounterRandom &random) noexcept;
 	double buildSea(double baseElevation, double seaSurfaceElevation) noexcept;
 	void buildAir(double baseElevation) noexcept;
 
 	//Relation Builders
 	//=================
 public: 
-	void buildAdjacency(std::map<my::Direction, MaterialColumn*> &adjacientColumns) noexcept; 
+	//columns holds every column by tile, and must stay where it is for as long as this column is linked to it
+	void buildAdjacency(const NeighborGraph &graph, int tile, const std::vector<MaterialColumn*> &columns) noexcept; 
+	//adjacency without building surfaces (restoring a snapshot)
+	void linkAdjacency(const NeighborGraph &graph, int tile, const std::vector<MaterialColumn*> &columns) noexcept;
 private:
 	void buildUniversalColumn() noexcept;
 
@@ -73,6 +82,29 @@ private:
 
 	void elevationChangeProcedure() noexcept;
 
+	//====================================================
+	//CHECKPOINT
+	//====================================================
+public:
+	//column values and layers. the universal column is rebuilt on read
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+
+	//surfaces point into neighboring columns, so they are read once every column's layers are restored and linked
+	void writeSurfaceSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSurfaceSnapshot(my::SnapshotReader &reader) noexcept;
+
+	//column values, layers and owned surfaces, read in place: nothing is reallocated or relinked, so the
+	//layout must be the one that was written (band exchange between processes forked from one world)
+	void writeState(my::SnapshotWriter &writer) const noexcept;
+	void readState(my::SnapshotReader &reader) noexcept;
+
+private:
+	//a layer is stored as (column, position in that column's _column). column is a my::Direction, or kOwnColumn
+	static const int kOwnColumn = -1;
+	void writeLayerReference(my::SnapshotWriter &writer, const MaterialLayer *layer) const noexcept;
+	MaterialLayer *readLayerReference(my::SnapshotReader &reader) noexcept;
+
 	//====================================================
 	//SIMULATION
 	//====================================================
@@ -83,6 +115,8 @@ public:
 	void simulateEvaporation() noexcept;
 	void simulateInfraredRadiation() noexcept;
 	void simulateConduction() noexcept;
+	//IMPLICIT_VERTICAL_CONDUCTION: conduction through the top surfaces, earth to the highest air layer, as one backward Euler system
+	void simulateVerticalConduction() noexcept;
 	void simulatePressure() noexcept;
 	void simulateCondensation() noexcept;
 	void simulatePrecipitation() noexcept;
@@ -90,14 +124,25 @@ public:
 	void simulateWaterFlow() noexcept;
 	void simulatePlants() noexcept;
 
+	//for the ClimateStore, which runs radiation on its own copy of the column
+	void setRadiationBudget(double backRadiation, double escapeRadiation) noexcept;
+
+private:
+	//conductivity*area of the top surface of _column[level], 0 at the top of the column
+	double topConductance(int level) const noexcept;
+public:
 
 	//====================================================
 	//GETTERS
 	//====================================================
 
 	double getLandElevation() const noexcept;
+	const std::vector<MaterialLayer*> &getColumn() const noexcept;
+	MaterialLayer *getSurfaceLayer() noexcept;//emits infrared upward
 	double getSurfaceTemperature() const noexcept;
 	double getBoundaryLayerTemperature() const noexcept;
+	double getBackRadiation() const noexcept;//infrared returned to the surface last hour
+	double getEscapeRadiation() const noexcept;//infrared lost to space last hour
 
 	std::vector<std::string> getMessages(const StatRequest &statRequest) const noexcept;
 
@@ -1,5 +1,6 @@
 #include "material-layer.h"
 #include "world.h"
+#include "checkpoint.h"
 
 
 namespace pleistocene {
@@ -32,6 +33,42 @@ void MaterialLayer::clearSurfaces() noexcept
 	_sharedSurfaces.clear();
 }
 
+void MaterialLayer::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_bottomElevation);
+	writer.write(_height);
+	writer.write(_topElevation);
+	writer.write(_baseElevation);
+	writer.write(_bottomRelativeElevation);
+	writer.write(_topRelativeElevation);
+	writer.write(_layerType);
+	writer.write(_emittor);
+}
+
+void MaterialLayer::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	reader.read(_bottomElevation);
+	reader.read(_height);
+	reader.read(_topElevation);
+	reader.read(_baseElevation);
+	reader.read(_bottomRelativeElevation);
+	reader.read(_topRelativeElevation);
+	reader.read(_layerType);
+	reader.read(_emittor);
+}
+
+void MaterialLayer::writeState(my::SnapshotWriter &writer) const noexcept
+{
+	MaterialLayer::writeSnapshot(writer);
+	_mixture->writeSnapshot(writer);
+}
+
+void MaterialLayer::readState(my::SnapshotReader &reader) noexcept
+{
+	MaterialLayer::readSnapshot(reader);
+	_mixture->readSnapshot(reader);
+}
+
 //SIMULATION
 //==============================
 
@@ -41,22 +78,12 @@ void MaterialLayer::hourlyClear() noexcept
 }
 
 
-void MaterialLayer::filterSolarRadiation(double energyKJ) noexcept
+double MaterialLayer::filterSolarRadiation(double energyKJ) noexcept
 {
 	if (_up == nullptr) {//stratosphere
-		energyKJ= _mixture->filterSolarRadiation(3*energyKJ)/3;
-	}
-	else {
-		energyKJ = _mixture->filterSolarRadiation(energyKJ);
-	}
-
-	//don't send down less than a joule
-	if (energyKJ > 0.001) {
-		//if down is nullptr the sunlight has reached the abyss and you have bigger problems
-		if (_down == nullptr) { LOG("Sun to bedrock?"); exit(EXIT_FAILURE); }
-
-		_down->filterSolarRadiation(energyKJ);	//chain downward
+		return _mixture->filterSolarRadiation(3*energyKJ)/3;
 	}
+	return _mixture->filterSolarRadiation(energyKJ);
 }
 
 double MaterialLayer::emitInfraredRadiation() noexcept
@@ -69,9 +96,10 @@ double MaterialLayer::filterInfraredRadiation(double energyKJ) noexcept
 	return _mixture->filterInfrared(energyKJ);
 }
 
-void MaterialLayer::simulateConduction() noexcept
+void MaterialLayer::simulateConduction(bool includeVertical) noexcept
 {
 	for (SharedSurface &surface : _sharedSurfaces) {
+		if (!includeVertical && surface._spatialDirection == UP) continue;
 		surface.performConduction();
 	}
 }
@@ -96,6 +124,8 @@ double MaterialLayer::getTopElevation() const noexcept { return _topElevation; }
 double MaterialLayer::getTemperature() const noexcept { return _mixture->getTemperature(); }
 LayerType MaterialLayer::getType() const noexcept { return _layerType; }
 elements::Mixture *MaterialLayer::getMixture() const noexcept { return _mixture; }
+std::vector<SharedSurface> &MaterialLayer::getSharedSurfaces() noexcept { return _sharedSurfaces; }
+const std::vector<SharedSurface> &MaterialLayer::getSharedSurfaces() const noexcept { return _sharedSurfaces; }
 
 std::vector<std::string> MaterialLayer::getMessages(const StatRequest &statRequest) const noexcept
 {
@@ -199,7 +229,8 @@ Eigen::Vector2d MaterialLayer::getAdvection() const noexcept
 
 EarthLayer::EarthLayer() noexcept {}
 
-EarthLayer::EarthLayer(double baseElevation, double temperature, double bottomElevation, double layerHeight, bool emittor) noexcept :
+EarthLayer::EarthLayer(double baseElevation, double temperature, double bottomElevation, double layerHeight, bool emittor,
+	my::CounterRandom random) noexcept :
 MaterialLayer(baseElevation, bottomElevation, emittor),
 _solidPtr(new elements::SolidMixture())
 {//normal constructor
@@ -210,12 +241,11 @@ _solidPtr(new elements::SolidMixture())
 
 	std::vector<Element> elementVector;
 
-	elementVector = generateSoil(earth::bedrockDepth-_bottomRelativeElevation, layerHeight);//-_bottomRelativeElevation is depth below surface
+	elementVector = generateSoil(earth::bedrockDepth-_bottomRelativeElevation, layerHeight, random);//-_bottomRelativeElevation is depth below surface
 
 	//unique_ptr setup.
 	std::unique_ptr<SolidMixture> temp(new SolidMixture(elementVector, temperature));
 	_solidPtr = std::move(temp);
-	temp.~unique_ptr();
 	_mixture = _solidPtr.get();//raw (non-owning) base class pointer setup
 	_mixture->_emittor = emittor;
 
@@ -226,7 +256,7 @@ _solidPtr(new elements::SolidMixture())
 
 
 
-std::vector<elements::Element> EarthLayer::generateSoil(double depth, double height) noexcept
+std::vector<elements::Element> EarthLayer::generateSoil(double depth, double height, my::CounterRandom &random) noexcept
 {
 	using namespace elements;
 	using namespace layers::earth;
@@ -236,7 +266,7 @@ std::vector<elements::Element> EarthLayer::generateSoil(double depth, double hei
 	Element element;
 	std::vector<Element> elementVector;
 
-	ElementType earthLayerType = determineEarthType(depthIndex);
+	ElementType earthLayerType = determineEarthType(depthIndex, random);
 	ElementType soilLayerType;
 
 	switch (earthLayerType) {
@@ -252,7 +282,7 @@ std::vector<elements::Element> EarthLayer::generateSoil(double depth, double hei
 
 		//up to three types of soil mixed together
 		for (int i = 0; i < 4; i++) {
-			soilLayerType = determineSoilType(depthIndex);
+			soilLayerType = determineSoilType(depthIndex, random);
 			element = Element(VOLUME, soilLayerType, height/4.0, SOLID);
 			elementVector.push_back(element);
 		}
@@ -260,14 +290,14 @@ std::vector<elements::Element> EarthLayer::generateSoil(double depth, double hei
 	}
 }
 
-elements::ElementType EarthLayer::determineEarthType(double depthIndex) noexcept
+elements::ElementType EarthLayer::determineEarthType(double depthIndex, my::CounterRandom &random) noexcept
 {
 	using namespace elements;
 
 	//depthIndex is from 0 to 1 (0=surface, 1=bedrockBottom)
 
 	//randomDouble is from 0 to 1;
-	double randomDouble = my::uniformRandom();
+	double randomDouble = random.uniform();
 	//double randomDouble = 0.3;
 
 	//soilRV : soil Random Variable from 0 to 1. 
@@ -280,7 +310,7 @@ elements::ElementType EarthLayer::determineEarthType(double depthIndex) noexcept
 	return CLAY; //stand in for "SOIL".  Move on to soil determination
 }
 
-elements::ElementType EarthLayer::determineSoilType(double depthIndex) noexcept
+elements::ElementType EarthLayer::determineSoilType(double depthIndex, my::CounterRandom &random) noexcept
 {
 	using namespace elements;
 
@@ -289,8 +319,8 @@ elements::ElementType EarthLayer::determineSoilType(double depthIndex) noexcept
 	//depthIndex is from 0 to 1 (0=surface, 1=bedrockBottom)
 	//Not used here yet but eventually probably
 
-	//uniformRandom is from 0 to 1;
-	double soilRV = my::uniformRandom();
+	//soilRV is from 0 to 1;
+	double soilRV = random.uniform();
 	//double soilRV = 0.36;
 	if (soilRV > 0.67) { return CLAY; }
 	else if (soilRV > 0.33) { return SILT; }
@@ -299,6 +329,20 @@ elements::ElementType EarthLayer::determineSoilType(double depthIndex) noexcept
 
 elements::SolidMixture *EarthLayer::getSolidPtr() noexcept { return _solidPtr.get(); }
 
+void EarthLayer::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	MaterialLayer::writeSnapshot(writer);
+	_solidPtr->writeSnapshot(writer);
+}
+
+void EarthLayer::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	MaterialLayer::readSnapshot(reader);
+	_solidPtr.reset(new elements::SolidMixture());
+	_solidPtr->readSnapshot(reader);
+	_mixture = _solidPtr.get();
+}
+
 //SIMULATION
 //===========================
 
@@ -356,8 +400,8 @@ double EarthLayer::getStatistic(const StatRequest &statRequest) const noexcept
 
 HorizonLayer::HorizonLayer() noexcept {}
 
-HorizonLayer::HorizonLayer(double baseElevation, double temperature, double bottomElevation, bool emittor) noexcept :
-EarthLayer(baseElevation, temperature, bottomElevation, layers::earth::topSoilHeight, emittor)
+HorizonLayer::HorizonLayer(double baseElevation, double temperature, double bottomElevation, bool emittor, my::CounterRandom random) noexcept :
+EarthLayer(baseElevation, temperature, bottomElevation, layers::earth::topSoilHeight, emittor, random)
 {
 	_layerType = HORIZON;//overwrite
 }
@@ -427,7 +471,6 @@ _liquidPtr(new elements::LiquidMixture())
 	//unique_ptr setup.
 	std::unique_ptr<LiquidMixture> temp(new LiquidMixture(elementVector, temperature));
 	_liquidPtr = std::move(temp);
-	temp.~unique_ptr();
 	_mixture = _liquidPtr.get();//raw (non-owning) base class pointer setup
 	_mixture->_emittor = emittor;
 
@@ -440,6 +483,20 @@ _liquidPtr(new elements::LiquidMixture())
 
 elements::LiquidMixture *SeaLayer::getLiquidPtr() noexcept { return _liquidPtr.get(); }
 
+void SeaLayer::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	MaterialLayer::writeSnapshot(writer);
+	_liquidPtr->writeSnapshot(writer);
+}
+
+void SeaLayer::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	MaterialLayer::readSnapshot(reader);
+	_liquidPtr.reset(new elements::LiquidMixture());
+	_liquidPtr->readSnapshot(reader);
+	_mixture = _liquidPtr.get();
+}
+
 
 
 //SIMULATION
@@ -496,12 +553,13 @@ _gasPtr(new elements::GaseousMixture)
 	//unique_ptr setup.
 	std::unique_ptr<GaseousMixture> temp(new GaseousMixture(air, temperature, _bottomElevation, _topElevation));
 	_gasPtr = std::move(temp);
-	temp.~unique_ptr();
 	_mixture = _gasPtr.get();//raw (non-owning) base class pointer setup
 	_mixture->_emittor = true;
 
 	_height = _topElevation - _bottomElevation;
 	_topRelativeElevation = _bottomRelativeElevation + _height;
+
+	_expectedMols = expectedMolsCalculator(_bottomElevation, _topElevation);
 }
 
 std::vector<elements::Element> AirLayer::generateAirElements(double bottomElevation, double topElevation) noexcept
@@ -526,8 +584,27 @@ void AirLayer::addAirSurface(SharedAirSurface &airSurface) noexcept
 	_sharedAirSurfaces.push_back(airSurface);
 }
 
+std::vector<SharedAirSurface> &AirLayer::getSharedAirSurfaces() noexcept { return _sharedAirSurfaces; }
+const std::vector<SharedAirSurface> &AirLayer::getSharedAirSurfaces() const noexcept { return _sharedAirSurfaces; }
+
 elements::GaseousMixture *AirLayer::getGasPtr() noexcept { return _gasPtr.get(); }
 
+void AirLayer::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	MaterialLayer::writeSnapshot(writer);
+	_gasPtr->writeSnapshot(writer);
+}
+
+void AirLayer::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	MaterialLayer::readSnapshot(reader);
+	_gasPtr.reset(new elements::GaseousMixture());
+	_gasPtr->readSnapshot(reader);
+	_mixture = _gasPtr.get();
+
+	_expectedMols = expectedMolsCalculator(_bottomElevation, _topElevation);
+}
+
 //SIMULATION
 //=========================
 
@@ -622,38 +699,36 @@ double AirLayer::expectedTemperatureCalculator(double elevation) noexcept
 	return expectedTemperature;
 }
 
-double AirLayer::lapsedTemperatureCalculator(double elevation) const noexcept
+double AirLayer::truePressureCalculator(double elevation) const noexcept
+{
+	return getPressure(pressureProfile(elevation));
+}
+
+PressureProfile AirLayer::pressureProfile(double elevation) const noexcept
 {
 	using namespace layers::air;
 
-	//choose set of standard values based on elevation
+	PressureProfile profile;
+	profile.expectedTemperature = expectedTemperatureCalculator(elevation);
+	profile.expectedPressure = expectedHydrostaticPressureCalculator(elevation);
+
+	//the layer's temperature lapsed from its bottom elevation, less the temperature itself
 	int i;
 	if (elevation > StandardElevation[0]) { i = 1; }
 	else { i = 0; }
+	profile.lapse = StandardLapseRate[i] * (elevation - _bottomElevation);//Alternatively we can calculate a moist adiabatic lapse rate
 
-	//parameters
-	double To = _gasPtr->getTemperature();
-	double L = StandardLapseRate[i];//Alternatively we can calculate a moist adiabatic lapse rate
-	double h = elevation;
-	double ho = _bottomElevation;
-
-	double LapsedTemperature = To + L*(h - ho);
+	if (_expectedMols <= 0 || profile.expectedTemperature <= 0) { LOG("pressure calculator divide by zero"); exit(EXIT_FAILURE); }
 
-	return LapsedTemperature;
+	return profile;
 }
 
-double AirLayer::truePressureCalculator(double elevation) const noexcept
+double AirLayer::getPressure(const PressureProfile &profile) const noexcept
 {
-	double ExpectedMols = expectedMolsCalculator(_bottomElevation, _topElevation);
-	double ExpectedTemperature = expectedTemperatureCalculator(elevation);
-	double ExpectedPressure = expectedHydrostaticPressureCalculator(elevation);
-
 	double TrueMols = _gasPtr->getMols();
-	double TrueTemperature = lapsedTemperatureCalculator(elevation);
-
-	if (ExpectedMols <= 0 || ExpectedTemperature <= 0) { LOG("pressure calculator divide by zero"); exit(EXIT_FAILURE);}
+	double TrueTemperature = _gasPtr->getTemperature() + profile.lapse;
 
-	double TruePressure = (TrueMols / ExpectedMols) * (TrueTemperature / ExpectedTemperature) * ExpectedPressure;
+	double TruePressure = (TrueMols / _expectedMols) * (TrueTemperature / profile.expectedTemperature) * profile.expectedPressure;
 
 	return TruePressure;
 }
@@ -707,7 +782,7 @@ double AirLayer::getStatistic(const StatRequest &statRequest) const noexcept
 	switch (statRequest._statType) {
 	case(ELEVATION) : return _bottomElevation;
 	case(TEMPERATURE) : return this->getTemperature();
-	case(MATERIAL_PROPERTIES) : return _gasPtr->getMols()-expectedMolsCalculator(_bottomElevation,_topElevation);
+	case(MATERIAL_PROPERTIES) : return _gasPtr->getMols()-_expectedMols;
 	case(PRESSURE) : return (getPressure(_bottomElevation)-expectedHydrostaticPressureCalculator(_bottomElevation));
 	case(FLOW) : {
 		if(_up!=nullptr){return _sharedAirSurfaces.front().getNetFlux();}
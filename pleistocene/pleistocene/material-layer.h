@@ -12,7 +12,7 @@ struct StatRequest;
 namespace climate {
 namespace layers {
 
-enum LayerType {
+enum LayerType : int {
 	EARTH,
 	SEA,
 	HORIZON,
@@ -62,8 +62,8 @@ const double airElevations[kMaxAirLayers] = { 0, troposphereLayerHeight, 2 * tro
 
 
 const double R = 8.31432;	//universal gas constant (J/(k*mol))
-const double Md = 0.0289644;	//Molar mass of dry air
-const double Mv = 0.0180153;	//Molar mass of water vapor
+constexpr double Md = 0.0289644;	//Molar mass of dry air
+constexpr double Mv = 0.0180153;	//Molar mass of water vapor
 const double g = 9.80665;
 
 const double StandardElevation[2] = { 0,11000 };
@@ -114,18 +114,26 @@ public:
 	virtual void addSurface(SharedSurface &surface) noexcept;
 	void clearSurfaces() noexcept;
 
+	//checkpoint. layer fields and the owned mixture; _up/_down and surfaces are relinked by the MaterialColumn
+	virtual void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	virtual void readSnapshot(my::SnapshotReader &reader) noexcept;
+	//the same values, read into the existing mixture so pointers to it stay valid (band exchange, see MaterialColumn::readState)
+	void writeState(my::SnapshotWriter &writer) const noexcept;
+	void readState(my::SnapshotReader &reader) noexcept;
+
 	//SIMULATION
 	//============================
 
 	void hourlyClear() noexcept;
 
-	//chains downward
-	void filterSolarRadiation(double energyKJ) noexcept;
+	//returns what passes on to the layer below (MaterialColumn::filterSolarRadiation walks the column)
+	double filterSolarRadiation(double energyKJ) noexcept;
 
 	double emitInfraredRadiation() noexcept;
 	double filterInfraredRadiation(double energyKJ) noexcept;
 
-	void simulateConduction() noexcept;
+	//includeVertical false leaves the top surface to the column's implicit solve
+	void simulateConduction(bool includeVertical = true) noexcept;
 
 	virtual void computeSurfacePressures() noexcept;
 
@@ -138,6 +146,8 @@ public:
 	virtual double getTemperature() const noexcept;
 	LayerType getType() const noexcept;
 	elements::Mixture *getMixture() const noexcept;
+	std::vector<SharedSurface> &getSharedSurfaces() noexcept;
+	const std::vector<SharedSurface> &getSharedSurfaces() const noexcept;
 
 	virtual double getPressure(double elevation) const noexcept;
 	virtual Eigen::Vector2d getAdvection() const noexcept;
@@ -161,12 +171,17 @@ protected:
 
 public:
 	EarthLayer() noexcept;
-	EarthLayer(double baseElevation, double temperature, double bottomElevation, double layerHeight, bool emittor) noexcept;
+	//random is this layer's own stream, see my::CounterRandom
+	EarthLayer(double baseElevation, double temperature, double bottomElevation, double layerHeight, bool emittor,
+		my::CounterRandom random) noexcept;
 
 	//void addEarthSurface(SharedEarthSurface &earthSurface) noexcept;
 
 	void simulateFlow() noexcept;
 
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+
 	elements::SolidMixture *getSolidPtr() noexcept;
 
 	//Message getter
@@ -181,9 +196,9 @@ private:
 	//Groundwater flow
 
 	//Earth Material constructors
-	static std::vector<elements::Element> generateSoil(double depth, double height) noexcept;
-	static elements::ElementType determineEarthType(double depthIndex) noexcept;
-	static elements::ElementType determineSoilType(double depthIndex) noexcept;
+	static std::vector<elements::Element> generateSoil(double depth, double height, my::CounterRandom &random) noexcept;
+	static elements::ElementType determineEarthType(double depthIndex, my::CounterRandom &random) noexcept;
+	static elements::ElementType determineSoilType(double depthIndex, my::CounterRandom &random) noexcept;
 };
 
 
@@ -211,7 +226,7 @@ class HorizonLayer : public EarthLayer {
 public:
 	HorizonLayer() noexcept;
 	//~HorizonLayer() noexcept;
-	HorizonLayer(double baseElevation, double temperature, double bottomElevation, bool emittor) noexcept;
+	HorizonLayer(double baseElevation, double temperature, double bottomElevation, bool emittor, my::CounterRandom random) noexcept;
 
 	//Message getter
 	std::vector<std::string> getMessages(const struct StatRequest &statRequest) const noexcept;
@@ -272,6 +287,9 @@ public:
 
 	//void addSeaSurface(SharedSeaSurface &seaSurface) noexcept;
 
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+
 	elements::LiquidMixture *getLiquidPtr() noexcept;
 
 	//Message getter
@@ -292,6 +310,8 @@ class AirLayer : public MaterialLayer {
 
 	std::unique_ptr<elements::GaseousMixture> _gasPtr;
 
+	double _expectedMols = 0;//expectedMolsCalculator over the layer, fixed by its elevations
+
 	double incidentUpRadiation;
 	double incidentDownRadiation;
 
@@ -303,6 +323,11 @@ public:
 
 	void addSurface(SharedSurface &surface) noexcept;
 	void addAirSurface(SharedAirSurface &airSurface) noexcept;
+	std::vector<SharedAirSurface> &getSharedAirSurfaces() noexcept;
+	const std::vector<SharedAirSurface> &getSharedAirSurfaces() const noexcept;
+
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
 
 	void computeSurfacePressures() noexcept;
 
@@ -317,13 +342,17 @@ private:
 	static double expectedMolsCalculator(double bottomElevation, double topElevation) noexcept;
 	static double expectedTemperatureCalculator(double elevation) noexcept;
 
-	double lapsedTemperatureCalculator(double elevation) const noexcept;
 	double truePressureCalculator(double elevation) const noexcept;
 
 public:
 
 	double getPressure(double elevation) const noexcept;
 
+	//truePressureCalculator split in two: the pow-heavy expected terms at an elevation, computed once,
+	//and the closed form that scales them by the layer's current mols and temperature
+	PressureProfile pressureProfile(double elevation) const noexcept;
+	double getPressure(const PressureProfile &profile) const noexcept;
+
 	double getTemperature() const noexcept;
 
 	//Message getter
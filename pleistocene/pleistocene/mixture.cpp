@@ -1,5 +1,6 @@
 #include "mixture.h"
 #include "tile-climate.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -58,14 +59,15 @@ void Mixture::calculateParameters() noexcept
 	calculateAlbedoIndex();
 	calculateSolarAbsorptionIndex();
 	calculateInfraredAbsorptionIndex();
+	_opticsOutOfDate = false;
 }
 
 void Mixture::calculateMass() noexcept 
 {
 	using namespace elements;
 	_totalMass = 0;
-	for (const ElementPair &elementPair : _elements) {
-		_totalMass += elementPair.second.getMass();
+	for (const Element &element : _elements) {
+		_totalMass += element.getMass();
 	}
 }
 
@@ -78,8 +80,8 @@ void Mixture::calculateVolume() noexcept
 	}
 	else {
 		_totalVolume = 0;
-		for (const ElementPair &elementPair : _elements) {
-			_totalVolume += elementPair.second.getVolume();
+		for (const Element &element : _elements) {
+			_totalVolume += element.getVolume();
 		}
 	}
 }
@@ -91,8 +93,8 @@ void Mixture::calculateMols() noexcept
 	if (_state != GAS) { _totalMols = my::kFakeDouble; return; }
 
 	_totalMols = 0;
-	for (const ElementPair &elementPair : _elements) {
-		_totalMols += elementPair.second.getMols();
+	for (const Element &element : _elements) {
+		_totalMols += element.getMols();
 	}
 }
 
@@ -100,20 +102,20 @@ void Mixture::calculateHeatCapacity() noexcept
 {
 	using namespace elements;
 	_totalHeatCapacity = 0;
-	for (const ElementPair &elementPair : _elements) {
-		_totalHeatCapacity += elementPair.second.getHeatCapacity();
+	for (const Element &element : _elements) {
+		_totalHeatCapacity += element.getHeatCapacity();
 	}
 	//AUX
 }
 
-void Mixture::calculateAlbedoIndex() noexcept 
+void Mixture::calculateAlbedoIndex() const noexcept 
 {
 	using namespace elements;
 
 	if (_state == SOLID || _state == LIQUID) {//for solids/liquids albedo is a volume average of the surface elements
 		double weightedAlbedo = 0;
-		for (const ElementPair &elementPair : _elements) {
-			weightedAlbedo += elementPair.second.getAlbedo()*elementPair.second.getVolume();
+		for (const Element &element : _elements) {
+			weightedAlbedo += element.getAlbedo()*element.getVolume();
 		}
 		if (_totalVolume <= 0) { _albedo = 0; return; }
 		_albedo = weightedAlbedo / _totalVolume;
@@ -121,15 +123,15 @@ void Mixture::calculateAlbedoIndex() noexcept
 	}
 	else {//add the albedos
 		_albedo = 0;
-		for (const ElementPair &elementPair : _elements) {
-			_albedo += elementPair.second.getAlbedo();
+		for (const Element &element : _elements) {
+			_albedo += element.getAlbedo();
 		}
 		//AUX
 		_albedo = std::min(_albedo, 1.0);
 	}
 }
 
-void Mixture::calculateSolarAbsorptionIndex() noexcept 
+void Mixture::calculateSolarAbsorptionIndex() const noexcept 
 {
 	using namespace elements;
 
@@ -139,15 +141,15 @@ void Mixture::calculateSolarAbsorptionIndex() noexcept
 	}
 	else {
 		_solarAbsorptionIndex = 0;
-		for (const ElementPair &elementPair : _elements) {
-			_solarAbsorptionIndex += elementPair.second.getSolarAbsorptivity();
+		for (const Element &element : _elements) {
+			_solarAbsorptionIndex += element.getSolarAbsorptivity();
 		}
 		_solarAbsorptionIndex = std::min(_solarAbsorptionIndex, 1.0);
 		//LOG("Non-Solid solar absorption: " << _solarAbsorptionIndex);
 	}
 }
 
-void Mixture::calculateInfraredAbsorptionIndex() noexcept 
+void Mixture::calculateInfraredAbsorptionIndex() const noexcept 
 {
 	using namespace elements;
 
@@ -157,14 +159,45 @@ void Mixture::calculateInfraredAbsorptionIndex() noexcept
 	}
 	else {
 		_infraredAbsorptionIndex = 0;
-		for (const ElementPair &elementPair : _elements) {
-			_infraredAbsorptionIndex += elementPair.second.getInfraredAbsorptivity();
+		for (const Element &element : _elements) {
+			_infraredAbsorptionIndex += element.getInfraredAbsorptivity();
 		}
 		//AUX
 		_infraredAbsorptionIndex = std::min(_infraredAbsorptionIndex, 1.0);
 	}
 }
 
+void Mixture::scaleParameters(double proportion) noexcept
+{
+	using namespace elements;
+	proportion = std::max(proportion, 0.0);//elements resized by a negative proportion are emptied
+
+	_totalMass *= proportion;
+	if (!_volumeIsFixed) { _totalVolume *= proportion; }
+	if (_state == GAS) { _totalMols *= proportion; }
+	_totalHeatCapacity *= proportion;
+	_opticsOutOfDate = true;
+}
+
+void Mixture::addParameters(double mass, double volume, double mols, double heatCapacity) noexcept
+{
+	using namespace elements;
+	_totalMass += mass;
+	if (!_volumeIsFixed) { _totalVolume += volume; }
+	if (_state == GAS) { _totalMols += mols; }
+	_totalHeatCapacity += heatCapacity;
+	_opticsOutOfDate = true;
+}
+
+void Mixture::refreshOptics() const noexcept
+{
+	if (!_opticsOutOfDate) { return; }
+	calculateAlbedoIndex();
+	calculateSolarAbsorptionIndex();
+	calculateInfraredAbsorptionIndex();
+	_opticsOutOfDate = false;
+}
+
 
 //=====================================================================================================================
 //MIXING MIXTURES
@@ -186,11 +219,11 @@ Mixture Mixture::copyProportion(double proportion) const noexcept
 
 void Mixture::resizeBy(double proportion) noexcept 
 {
-	for (elements::ElementPair &elementPair : _elements) {
-		elementPair.second.resizeBy(proportion);
+	for (Element &element : _elements) {
+		element.resizeBy(proportion);
 	}
 	_inertia *= proportion;
-	calculateParameters();
+	scaleParameters(proportion);
 }
 
 void Mixture::push(Mixture &addedMixture) noexcept 
@@ -203,10 +236,11 @@ void Mixture::push(Mixture &addedMixture) noexcept
 
 	//_inertia += addedMixture._inertia;
 
-	for (ElementPair &elementPair : addedMixture._elements) {
-		pushSpecific(elementPair.second);
+	for (Element &element : addedMixture._elements) {
+		pushSpecific(element);
 	}
-	calculateParameters();
+	addParameters(addedMixture._totalMass, addedMixture._totalVolume, addedMixture._totalMols,
+		addedMixture._totalHeatCapacity);
 }
 
 void Mixture::pushSpecific(Element addedSpecificElement, double temperature, bool temperatureSpecified) noexcept 
@@ -224,12 +258,12 @@ void Mixture::pushSpecific(Element addedSpecificElement, double temperature, boo
 		return;
 	}
 	else {
-		if (_elements.count(eType)) {
+		if (_elements.contains(eType)) {
 			_elements[eType].combineLike(addedSpecificElement);
 			return;
 		}
 		else {
-			_elements[eType] = addedSpecificElement;
+			_elements.insert(addedSpecificElement);
 			return;
 		}
 	}
@@ -241,12 +275,11 @@ double Mixture::pullSpecific(Element pulledElement) noexcept
 	ElementType eType = pulledElement.getElementType();
 	double massPulled = 0.0;
 	double massRequested = pulledElement.getMass();
-	if (_elements.count(eType)) {
+	if (_elements.contains(eType)) {
 		massPulled = _elements[eType].pullMass(massRequested);
 
 		if (_elements[eType].getMass() <= 0) {//you took everything
-			auto iterator = _elements.find(eType);
-			_elements.erase(iterator);
+			_elements.erase(eType);
 		}
 	}
 	return massPulled;
@@ -259,8 +292,9 @@ double Mixture::pullSpecific(Element pulledElement) noexcept
 double Mixture::filterSolarRadiation(double solarEnergyKJ) noexcept 
 {
 	if (solarEnergyKJ <= 0) { return 0; }
+	refreshOptics();
 
-	if (_elements.size() == 0) { LOG("NO COMPONENTS"); exit(EXIT_FAILURE); return solarEnergyKJ; }
+	if (_elements.empty()) { LOG("NO COMPONENTS"); exit(EXIT_FAILURE); return solarEnergyKJ; }
 	if (_totalHeatCapacity <= 0) { LOG("ZERO HEAT CAPACITY"); exit(EXIT_FAILURE); return solarEnergyKJ; }
 	if (_albedo < 0 || _albedo>1) { LOG("WEIRD ALBEDO"); exit(EXIT_FAILURE); return solarEnergyKJ; }
 
@@ -283,7 +317,8 @@ double Mixture::filterSolarRadiation(double solarEnergyKJ) noexcept
 
 double Mixture::filterInfrared(double infraredEnergy) noexcept
 {
-	if (_elements.size() == 0) { LOG("NO COMPONENTS");  exit(EXIT_FAILURE); return infraredEnergy; }//dummy return
+	if (_elements.empty()) { LOG("NO COMPONENTS");  exit(EXIT_FAILURE); return infraredEnergy; }//dummy return
+	refreshOptics();
 	if (_totalHeatCapacity <= 0) { LOG("ZERO HEAT CAPACITY");  exit(EXIT_FAILURE); return infraredEnergy; }//dummy return
 
 	double infraredAbsorbed = _infraredAbsorptionIndex*infraredEnergy;
@@ -303,7 +338,7 @@ double Mixture::filterInfrared(double infraredEnergy) noexcept
 
 double Mixture::emitInfrared() noexcept 
 {
-	if (_elements.size() == 0) { LOG("NO COMPONENTS"); exit(EXIT_FAILURE); return 0; }
+	if (_elements.empty()) { LOG("NO COMPONENTS"); exit(EXIT_FAILURE); return 0; }
 	if (_totalHeatCapacity <= 0) { LOG("ZERO HEAT CAPACITY");  exit(EXIT_FAILURE); return 0; }
 	if (_temperature <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); return 0; }
 
@@ -316,6 +351,13 @@ double Mixture::handleInOutRadiation() noexcept
 	
 	_equilibriumTemperature = calculateEquilibriumTemperature(_hourlyInfraredInput+_hourlySolarInput);
 
+	if (TileClimate::getRadiationScheme() == IMPLICIT_RADIATION) {
+		double input = _hourlyInfraredInput + _hourlySolarInput;
+		_hourlyInfraredInput = 0;
+		_hourlyOutputRadiation = radiateImplicit(_state == GAS, _totalMass, _totalHeatCapacity, _temperature, input);
+		return _hourlyOutputRadiation;
+	}
+
 	double postInputTemperature= _temperature + ((_hourlyInfraredInput+ _hourlySolarInput) / _totalHeatCapacity);
 	_hourlyInfraredInput = 0;
 
@@ -353,42 +395,104 @@ double Mixture::handleInOutRadiation() noexcept
 }
 
 double Mixture::calculateEquilibriumTemperature(double inputRadiation) const noexcept
+{
+	return calculateEquilibriumTemperature(_state == elements::GAS, _totalMass, inputRadiation);
+}
+
+double Mixture::calculateEmissions(double temperature) const noexcept
+{
+	return calculateEmissions(_state == GAS, _totalMass, temperature);
+}
+
+//input and emission are over a whole step (TileClimate::getStepHours)
+double Mixture::calculateEquilibriumTemperature(bool gas, double mass, double inputRadiation) noexcept
 {
 	double equilibriumTemperature;
+	double emissionConstant = kEmissionConstantPerHour*TileClimate::getStepHours();
 
-	if (_state == elements::GAS) {
-		equilibriumTemperature = pow(inputRadiation/(kEmissionConstantPerHour *_totalMass * 4 * pow(10, -4)), 0.25);
+	if (gas) {
+		equilibriumTemperature = pow(inputRadiation/(emissionConstant *mass * 4 * pow(10, -4)), 0.25);
 	}
 	else {
-		equilibriumTemperature = pow(inputRadiation/kEmissionConstantPerHour, 0.25);
+		equilibriumTemperature = pow(inputRadiation/emissionConstant, 0.25);
 	}
 
 	return equilibriumTemperature;
 }
 
-double Mixture::calculateEmissions(double temperature) const noexcept
+double Mixture::calculateEmissions(bool gas, double mass, double temperature) noexcept
 {
 	//calculate emission energy for this temperature
 	double emissionEnergy;
+	double emissionConstant = kEmissionConstantPerHour*TileClimate::getStepHours();
 
-	if (_state == GAS) {
-		emissionEnergy = kEmissionConstantPerHour *_totalMass * 4 * pow(10, -4) * pow(temperature, 4);
+	if (gas) {
+		emissionEnergy = emissionConstant *mass * 4 * pow(10, -4) * pow(temperature, 4);
 	}
 	else {
-		emissionEnergy = kEmissionConstantPerHour * pow(temperature, 4);
+		emissionEnergy = emissionConstant * pow(temperature, 4);
 	}
 
 	return emissionEnergy;
 }
 
+//Solves heatCapacity (T' - T) = input - E(T') for the temperature T' the step ends at, E being the step's emission at T'.
+//f(T') = heatCapacity (T' - T) - input + E(T') is increasing and convex in T', so the first Newton iterate from T
+//(the linearized implicit update) lies on or above the root, and the iterates after it fall monotonically onto it:
+//T' stays positive and never overshoots equilibrium, however long the step
+double Mixture::radiateImplicit(bool gas, double mass, double heatCapacity, double &temperature, double input) noexcept
+{
+	const int kMaxIterations = 8;
+	const double kTolerance = 1e-12;//relative
+
+	double emissionPerT4 = calculateEmissions(gas, mass, 1.0);
+	double startTemperature = temperature;
+	double endTemperature = temperature;
+
+	for (int iteration = 0; iteration < kMaxIterations; iteration++) {
+		double cube = endTemperature*endTemperature*endTemperature;
+		double residual = heatCapacity*(endTemperature - startTemperature) - input + emissionPerT4*cube*endTemperature;
+		double slope = heatCapacity + 4 * emissionPerT4*cube;
+		double correction = residual / slope;
+
+		endTemperature -= correction;
+		if (abs(correction) <= kTolerance*endTemperature) break;
+	}
+
+	temperature = endTemperature;
+
+	//whatever didn't stay as heat was emitted, so the step conserves energy exactly
+	return input - heatCapacity*(endTemperature - startTemperature);
+}
+
 void Mixture::conduction(Mixture &mixture1, Mixture &mixture2, double area) noexcept 
 {
 
 	if (area<0) { LOG("Negative Area");  exit(EXIT_FAILURE); return; }
 
-	double deltaT = mixture2._temperature - mixture1._temperature;
-	//Shitty conductivity estimate
+	double heatExchanged = conductiveExchange(mixture1._temperature, mixture1._totalHeatCapacity,
+		mixture2._temperature, mixture2._totalHeatCapacity, conductivity(mixture1, mixture2), area);
 
+	mixture1._temperature += heatExchanged / mixture1._totalHeatCapacity;
+	mixture2._temperature -= heatExchanged / mixture2._totalHeatCapacity;
+
+	mixture1._netConductiveExchange += heatExchanged;
+	mixture2._netConductiveExchange -= heatExchanged;
+
+	if(mixture1._temperature<=0 || mixture2._temperature <= 0){ LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+}
+
+void Mixture::conductTo(double temperature) noexcept
+{
+	_netConductiveExchange += _totalHeatCapacity*(temperature - _temperature);
+	_temperature = temperature;
+
+	if (_temperature <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+}
+
+double Mixture::conductivity(const Mixture &mixture1, const Mixture &mixture2) noexcept
+{
+	//Shitty conductivity estimate
 	double conductivity = pow(10, -7)*(kHour_s / 3600);
 
 	//Air-surface conduction sucks
@@ -405,36 +509,142 @@ void Mixture::conduction(Mixture &mixture1, Mixture &mixture2, double area) noex
 		conductivity *= 100;
 	}
 
+	return conductivity;
+}
+
+//heat flowing from the second mixture into the first
+double Mixture::conductiveExchange(double temperature1, double heatCapacity1,
+	double temperature2, double heatCapacity2, double conductivity, double area) noexcept
+{
+	double deltaT = temperature2 - temperature1;
 
-	//Calculate heat exchanged in conduction
-	double heatExchanged = deltaT*conductivity*area;
+	//Calculate heat exchanged in conduction (over the whole step)
+	double heatExchanged = deltaT*conductivity*area*TileClimate::getStepHours();
 	bool sign = signbit(heatExchanged);
 	heatExchanged = abs(heatExchanged);
 
 	//Check overstep
-	double totalHeat = mixture1._totalHeatCapacity*mixture1._temperature + mixture2._totalHeatCapacity*mixture2._temperature;
-	double equalizationTemp = totalHeat / (mixture1._totalHeatCapacity + mixture2._totalHeatCapacity);
+	double totalHeat = heatCapacity1*temperature1 + heatCapacity2*temperature2;
+	double equalizationTemp = totalHeat / (heatCapacity1 + heatCapacity2);
 
 	//heat exchange required to equilize temperatures
-	double maxHeatExchange = abs(equalizationTemp - mixture1._temperature)*mixture1._totalHeatCapacity;
+	double maxHeatExchange = abs(equalizationTemp - temperature1)*heatCapacity1;
 
 	//minimum
 	heatExchanged = std::min(maxHeatExchange, heatExchanged);
 	if (sign) heatExchanged = -heatExchanged;
 
-	mixture1._temperature += heatExchanged / mixture1._totalHeatCapacity;
-	mixture2._temperature -= heatExchanged / mixture2._totalHeatCapacity;
+	return heatExchanged;
+}
 
-	mixture1._netConductiveExchange += heatExchanged;
-	mixture2._netConductiveExchange -= heatExchanged;
+ThermalState Mixture::getThermalState() const noexcept
+{
+	refreshOptics();
+	ThermalState state;
+
+	state.temperature = _temperature;
+	state.heatCapacity = _totalHeatCapacity;
+	state.mass = _totalMass;
+	state.mols = _totalMols;
+	state.albedo = _albedo;
+	state.solarAbsorptionIndex = _solarAbsorptionIndex;
+	state.infraredAbsorptionIndex = _infraredAbsorptionIndex;
+	state.inertia = getInertia();
+
+	state.hourlySolarInput = _hourlySolarInput;
+	state.hourlyInfraredInput = _hourlyInfraredInput;
+	state.hourlyInfraredInputDisplay = _hourlyInfraredInputDisplay;
+	state.hourlyOutputRadiation = _hourlyOutputRadiation;
+	state.netConductiveExchange = _netConductiveExchange;
+	state.equilibriumTemperature = _equilibriumTemperature;
+
+	state.emittor = _emittor;
+	state.gas = (_state == GAS);
+
+	return state;
+}
 
-	if(mixture1._temperature<=0 || mixture2._temperature <= 0){ LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+void Mixture::setThermalState(const ThermalState &state) noexcept
+{
+	_temperature = state.temperature;
+
+	_hourlySolarInput = state.hourlySolarInput;
+	_hourlyInfraredInput = state.hourlyInfraredInput;
+	_hourlyInfraredInputDisplay = state.hourlyInfraredInputDisplay;
+	_hourlyOutputRadiation = state.hourlyOutputRadiation;
+	_netConductiveExchange = state.netConductiveExchange;
+	_equilibriumTemperature = state.equilibriumTemperature;
+}
+
+void Mixture::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	refreshOptics();
+	writer.write(int32_t(_elements.size()));
+	for (const Element &element : _elements) {
+		element.writeSnapshot(writer);
+	}
+
+	writer.write(_state);
+	writer.write(_temperature);
+	writer.write(_totalVolume);
+	writer.write(_fixedVolume);
+	writer.write(_volumeIsFixed);
+	writer.write(_totalMass);
+	writer.write(_totalHeatCapacity);
+	writer.write(_totalMols);
+	writer.write(_albedo);
+	writer.write(_solarAbsorptionIndex);
+	writer.write(_infraredAbsorptionIndex);
+
+	writer.write(_hourlySolarInput);
+	writer.write(_hourlyInfraredInput);
+	writer.write(_hourlyInfraredInputDisplay);
+	writer.write(_hourlyOutputRadiation);
+	writer.write(_netConductiveExchange);
+	writer.write(_equilibriumTemperature);
+
+	writer.writeVector(_inertia);
+	writer.write(_emittor);
+}
+
+void Mixture::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	_elements.clear();
+	int32_t elementCount = reader.read<int32_t>();
+	Element element;
+	for (int i = 0; i < elementCount; i++) {
+		element.readSnapshot(reader);
+		_elements.insert(element);
+	}
+
+	reader.read(_state);
+	reader.read(_temperature);
+	reader.read(_totalVolume);
+	reader.read(_fixedVolume);
+	reader.read(_volumeIsFixed);
+	reader.read(_totalMass);
+	reader.read(_totalHeatCapacity);
+	reader.read(_totalMols);
+	reader.read(_albedo);
+	reader.read(_solarAbsorptionIndex);
+	reader.read(_infraredAbsorptionIndex);
+	_opticsOutOfDate = false;
+
+	reader.read(_hourlySolarInput);
+	reader.read(_hourlyInfraredInput);
+	reader.read(_hourlyInfraredInputDisplay);
+	reader.read(_hourlyOutputRadiation);
+	reader.read(_netConductiveExchange);
+	reader.read(_equilibriumTemperature);
+
+	reader.readVector(_inertia);
+	reader.read(_emittor);
 }
 
 double Mixture::getTemperature() const noexcept { return _temperature; }
 double Mixture::getHeatCapacity() const noexcept { return _totalHeatCapacity; }
 double Mixture::getHeight() const noexcept { return _totalVolume; }
-double Mixture::getAlbedo() const noexcept { return _albedo; }
+double Mixture::getAlbedo() const noexcept { refreshOptics(); return _albedo; }
 double Mixture::getVolume() const noexcept { return _totalVolume; }
 double Mixture::getMass() const noexcept { return _totalMass; }
 double Mixture::getMols() const noexcept { return _totalMols; }
@@ -489,9 +699,10 @@ std::vector<std::string> Mixture::getElementMessages() const noexcept
 {
 	std::vector<std::string> messages;
 	std::vector<std::string> subMessages;
+	refreshOptics();
 
-	for (const ElementPair &elementPair : _elements) {
-		subMessages=elementPair.second.getMessages();
+	for (const Element &element : _elements) {
+		subMessages=element.getMessages();
 		messages.insert(messages.begin(), subMessages.begin(), subMessages.end());
 	}
 
@@ -8,9 +8,32 @@ namespace climate {
 namespace layers {
 namespace elements {
 
+//Per-layer values the ClimateStore works on in place of the Mixture
+struct ThermalState {
+	double temperature;
+	double heatCapacity;
+	double mass;
+	double mols;
+	double albedo;
+	double solarAbsorptionIndex;
+	double infraredAbsorptionIndex;
+	Eigen::Vector3d inertia;
+
+	//hourly energy budget
+	double hourlySolarInput;
+	double hourlyInfraredInput;
+	double hourlyInfraredInputDisplay;
+	double hourlyOutputRadiation;
+	double netConductiveExchange;
+	double equilibriumTemperature;
+
+	bool emittor;
+	bool gas;
+};
+
 class Mixture {
 protected:
-	std::map<elements::ElementType, Element> _elements;//main constituent elements
+	ElementSet _elements;//main constituent elements
 	elements::State _state;
 
 
@@ -22,9 +45,11 @@ protected:
 	double _totalHeatCapacity = 0;//kJ/(kg K)
 	double _totalMols = 0;
 
-	double _albedo = 0;//reflective index (proportion reflected passing through this material)
-	double _solarAbsorptionIndex = 0;//proportion absorbed passing through this material
-	double _infraredAbsorptionIndex = 0;//proportion absorbed passing through this material
+	//optical indices are recomputed on first read after the composition changes (refreshOptics)
+	mutable double _albedo = 0;//reflective index (proportion reflected passing through this material)
+	mutable double _solarAbsorptionIndex = 0;//proportion absorbed passing through this material
+	mutable double _infraredAbsorptionIndex = 0;//proportion absorbed passing through this material
+	mutable bool _opticsOutOfDate = false;
 
 	double _hourlySolarInput = 0;
 	//double _dailySolarInput = 0;
@@ -64,9 +89,15 @@ protected:
 	virtual void calculateMols() noexcept;
 	virtual void calculateHeatCapacity() noexcept;
 
-	virtual void calculateAlbedoIndex() noexcept;
-	virtual void calculateSolarAbsorptionIndex() noexcept;
-	virtual void calculateInfraredAbsorptionIndex() noexcept;
+	virtual void calculateAlbedoIndex() const noexcept;
+	virtual void calculateSolarAbsorptionIndex() const noexcept;
+	virtual void calculateInfraredAbsorptionIndex() const noexcept;
+
+	//keep the totals up to date without going back over the elements: a proportional resize scales them,
+	//an added mixture adds its own. either leaves the optical indices out of date
+	virtual void scaleParameters(double proportion) noexcept;
+	void addParameters(double mass, double volume, double mols, double heatCapacity) noexcept;
+	void refreshOptics() const noexcept;
 
 public:
 	//=======================================
@@ -92,6 +123,25 @@ public:
 	double emitInfrared() noexcept;
 	double filterInfrared(double infraredEnergyKJ) noexcept;
 	static void conduction(Mixture &mixture1, Mixture &mixture2, double area) noexcept;
+	//temperature the mixture reaches by (implicit) conduction this step. the heat goes to the net conductive exchange
+	void conductTo(double temperature) noexcept;
+
+	//radiation and conduction arithmetic shared with the ClimateStore kernels
+	static double calculateEmissions(bool gas, double mass, double temperature) noexcept;
+	static double calculateEquilibriumTemperature(bool gas, double mass, double inputRadiation) noexcept;
+	//IMPLICIT_RADIATION: updates temperature for input absorbed over the step, returns the energy emitted
+	static double radiateImplicit(bool gas, double mass, double heatCapacity, double &temperature, double input) noexcept;
+	static double conductivity(const Mixture &mixture1, const Mixture &mixture2) noexcept;
+	static double conductiveExchange(double temperature1, double heatCapacity1,
+		double temperature2, double heatCapacity2, double conductivity, double area) noexcept;
+
+	ThermalState getThermalState() const noexcept;
+	//writes back temperature and the hourly energy budget. composition-derived values (heat capacity, indices...) are left alone
+	void setThermalState(const ThermalState &state) noexcept;
+
+	//checkpoint. the whole mixture including composition, so nothing needs recalculating after a restore
+	virtual void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	virtual void readSnapshot(my::SnapshotReader &reader) noexcept;
 
 	//=======================================
 	//GETTERS
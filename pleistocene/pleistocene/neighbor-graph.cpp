@@ -0,0 +1,39 @@
+#include "neighbor-graph.h"
+
+namespace pleistocene {
+namespace simulation {
+
+const int NeighborGraph::kDirections;
+const int32_t NeighborGraph::kNoNeighbor;
+
+NeighborGraph::NeighborGraph() noexcept {}
+
+void NeighborGraph::build() noexcept
+{
+	int rows = my::Address::GetRows();
+	int cols = my::Address::GetCols();
+
+	_slots.assign(size_t(rows)*cols*kDirections, kNoNeighbor);
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++) {
+			my::Address A(row, col);
+			if (A.i == my::kFakeIndex) { LOG("not a valid Address");  exit(EXIT_FAILURE); }
+
+			for (int direction = 0; direction < kDirections; direction++) {
+				my::Address neighbor = A.adjacent(direction);
+				if (neighbor.i != my::kFakeIndex) _slots[size_t(A.i)*kDirections + direction] = neighbor.i;
+			}
+		}
+	}
+}
+
+int NeighborGraph::getTileCount() const noexcept { return int(_slots.size() / kDirections); }
+
+const int32_t *NeighborGraph::getNeighbors(int tile) const noexcept { return &_slots[size_t(tile)*kDirections]; }
+
+int32_t NeighborGraph::getNeighbor(int tile, my::Direction direction) const noexcept { return _slots[size_t(tile)*kDirections + direction]; }
+
+const std::vector<int32_t> &NeighborGraph::getSlots() const noexcept { return _slots; }
+
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,32 @@
+#pragma once
+#include "globals.h"
+
+namespace pleistocene {
+namespace simulation {
+
+//The hex grid's adjacency, flat: kDirections int32 slots per tile, in my::Direction order, kNoNeighbor where
+//the grid ends (the rows at the poles). Built once per grid and shared by the tiles' columns, the coloring and
+//the band decomposition, so kernels can stream over the slots instead of walking per tile maps
+class NeighborGraph {
+public:
+	static const int kDirections = 6;
+	static const int32_t kNoNeighbor = -1;
+
+	NeighborGraph() noexcept;
+
+	//for the current my::Address grid
+	void build() noexcept;
+
+	int getTileCount() const noexcept;
+	//the tile's kDirections slots
+	const int32_t *getNeighbors(int tile) const noexcept;
+	int32_t getNeighbor(int tile, my::Direction direction) const noexcept;
+	//every tile's slots, tile by tile
+	const std::vector<int32_t> &getSlots() const noexcept;
+
+private:
+	std::vector<int32_t> _slots;
+};
+
+}//namespace simulation
+}//namespace pleistocene
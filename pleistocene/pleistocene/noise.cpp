@@ -1,7 +1,12 @@
 #include "noise.h"
 #include <math.h>
 #include <limits>
+#include <climits>
+#include <stdint.h>
+#include <algorithm>
+#include <string.h>
 #include "utility.h"
+#include "worker-pool.h"
 
 namespace pleistocene {
 namespace noise {
@@ -43,56 +48,153 @@ double Noise2D(double x, double y, double seed) noexcept
 }
 
 
-std::vector<double> PerlinNoise(std::vector<std::pair<double, double>> positions, NoiseParameters parameters) noexcept 
+namespace {
+
+const int kNoiseBlock = 256;//positions per stage loop, so a block's scratch stays in L1
+
+//Pseudorandom2D at a lattice point. the int wrap-around is done in unsigned arithmetic (same bits, no overflow)
+inline double latticeValue(int x, int y, double seed) noexcept
 {
-	using namespace utility;
+	uint32_t n = uint32_t(int(double(x)*seed + double(y) * 57));
+	n = (n << 13) ^ n;
+	uint32_t nn = (n*(n*n * 60493u + 19990303u) + 1376312589u) & uint32_t(INT_MAX);
+	return 1.0 - ((double)nn / 1073741824.0);
+}
 
-	//returned noise vector
-	std::vector<double> noise_table;
+//Interpolate's weight
+inline double fade(double x) noexcept
+{
+	double ft = x * 3.1415927;
+	return (1.0 - cos(ft))* 0.5;
+}
 
-	//parameter unpacking
-	double seed = parameters.seed;
-	int octave_count= parameters.octaves;
-	double zoom= parameters.zoom;
-	double persistance = parameters.persistance;
+//fade of a scaled coordinate, remembered by its bits. positions on a grid keep repeating coordinates
+//(a row shares its y, rows share their x), and cos is most of the cost. a miss just recomputes
+class FadeCache {
+public:
+	FadeCache() noexcept : _keys(kSize), _fades(kSize), _filled(kSize, 0) {}
 
+	void clear() noexcept { std::fill(_filled.begin(), _filled.end(), 0); }
 
-	//build frequency and amplitude vectors
-	std::vector<double> frequencies;
-	std::vector<double> amplitudes;
+	double get(double fraction) noexcept
+	{
+		uint64_t key;
+		memcpy(&key, &fraction, sizeof(key));
+		int slot = int((key * 0x9E3779B97F4A7C15ull) >> (64 - kBits));
 
-	for (int octave : range( 0, octave_count)) {
-		frequencies.push_back(pow(2, octave));		//double frequency with each octave.
+		if (!_filled[slot] || _keys[slot] != key) {
+			_keys[slot] = key;
+			_fades[slot] = fade(fraction);
+			_filled[slot] = 1;
+		}
+		return _fades[slot];
+	}
 
-		amplitudes.push_back(pow(persistance, octave)); //scale down amplitude with each octave.
+private:
+	static const int kBits = 12;
+	static const int kSize = 1 << kBits;
 
+	std::vector<uint64_t> _keys;
+	std::vector<double> _fades;
+	std::vector<char> _filled;
+};
+
+//adds each octave, in order, to noise[begin, end)
+void noiseRange(const std::vector<std::pair<double, double>> &positions, int begin, int end, const NoiseParameters &parameters,
+	const std::vector<double> &frequencies, const std::vector<double> &amplitudes, double *noise) noexcept
+{
+	int cellX[kNoiseBlock], cellY[kNoiseBlock];
+	double fadeX[kNoiseBlock], fadeY[kNoiseBlock];
+	double corners[4];
+	FadeCache fadeCache;
+
+	for (int octave = 0; octave < parameters.octaves; octave++) {
+		double frequency = frequencies[octave];
+		double amplitude = amplitudes[octave];
+
+		fadeCache.clear();
+		int lastX = INT_MIN, lastY = INT_MIN;
+
+		for (int first = begin; first < end; first += kNoiseBlock) {
+			int count = std::min(kNoiseBlock, end - first);
+			const std::pair<double, double> *position = positions.data() + first;
+
+			for (int i = 0; i < count; i++) {
+				double X = double(position[i].first)*frequency / parameters.zoom;
+				double Y = double(position[i].second)*frequency / parameters.zoom;
+				cellX[i] = int(X);
+				cellY[i] = int(Y);
+				fadeX[i] = X - cellX[i];
+				fadeY[i] = Y - cellY[i];
+			}
+
+			for (int i = 0; i < count; i++) {
+				fadeX[i] = fadeCache.get(fadeX[i]);
+				fadeY[i] = fadeCache.get(fadeY[i]);
+			}
+
+			for (int i = 0; i < count; i++) {
+				//neighbors mostly share a cell at the low octaves, or the next cell along the row
+				if (cellY[i] == lastY && cellX[i] == lastX + 1) {
+					lastX = cellX[i];
+					corners[0] = corners[1];
+					corners[2] = corners[3];
+					corners[1] = latticeValue(lastX + 1, lastY, parameters.seed);
+					corners[3] = latticeValue(lastX + 1, lastY + 1, parameters.seed);
+				}
+				else if (cellX[i] != lastX || cellY[i] != lastY) {
+					lastX = cellX[i];
+					lastY = cellY[i];
+					corners[0] = latticeValue(lastX, lastY, parameters.seed);//bottom left
+					corners[1] = latticeValue(lastX + 1, lastY, parameters.seed);//bottom right
+					corners[2] = latticeValue(lastX, lastY + 1, parameters.seed);//upper left
+					corners[3] = latticeValue(lastX + 1, lastY + 1, parameters.seed);//upper right
+				}
+
+				double fx = fadeX[i];
+				double fy = fadeY[i];
+				double interpolation1 = corners[0]*(1.0 - fx) + corners[1]*fx;
+				double interpolation2 = corners[2]*(1.0 - fx) + corners[3]*fx;
+
+				noise[first + i] += (interpolation1*(1.0 - fy) + interpolation2*fy)*amplitude;
+			}
+		}
 	}
+}
 
-	//helps determine noise amplitude (this is a dummy value to be updated)
-	double maximum = 0.01;
+}//namespace
 
-	double X;  //x position variable (related to, but not the same as the literal tile position)
-	double Y;  //y position variable
-	
+std::vector<double> PerlinNoise(const std::vector<std::pair<double, double>> &positions, NoiseParameters parameters, my::WorkerPool *pool) noexcept
+{
+	using namespace utility;
 
-	for (auto position : positions) {
-		double getNoise = 0;
+	//returned noise vector
+	std::vector<double> noise_table(positions.size());
 
-		//loop through octaves
-		for (int octave : range(0, octave_count)) {
-			double frequency = frequencies[octave];
-			double amplitude = amplitudes[octave];
+	//build frequency and amplitude vectors
+	std::vector<double> frequencies;
+	std::vector<double> amplitudes;
+
+	for (int octave : range(0, parameters.octaves)) {
+		frequencies.push_back(pow(2, octave));		//double frequency with each octave.
 
-			X = double(position.first)*frequency / zoom;
-			Y = double(position.second)*frequency / zoom;
+		amplitudes.push_back(pow(parameters.persistance, octave)); //scale down amplitude with each octave.
 
-			getNoise += noise::Noise2D(X, Y, seed)*amplitude;
-		}
+	}
+
+	int count = int(positions.size());
+	int blocks = (count + kNoiseBlock - 1) / kNoiseBlock;
 
-		noise_table.emplace_back(getNoise);
+	auto task = [&](int begin, int end) {
+		noiseRange(positions, begin*kNoiseBlock, std::min(end*kNoiseBlock, count), parameters, frequencies, amplitudes, noise_table.data());
+	};
+	if (pool) { pool->run(blocks, task); }
+	else { task(0, blocks); }
 
-		//update maximum
-		if (abs(getNoise) > maximum) maximum = abs(getNoise);
+	//helps determine noise amplitude (this is a dummy value to be updated)
+	double maximum = 0.01;
+	for (double noise_value : noise_table) {
+		if (abs(noise_value) > maximum) maximum = abs(noise_value);
 	}
 
 	//Rescale with maximum so ranges in noiseTable are from -1 to 1. 
@@ -2,6 +2,9 @@
 #include <vector>
 
 namespace pleistocene {
+
+namespace my { class WorkerPool; }
+
 namespace noise {
 
 struct NoiseParameters {
@@ -15,7 +18,11 @@ double Interpolate(double a, double b, double x) noexcept;
 
 double Noise2D(double x, double y, double seed) noexcept;
 
-std::vector<double> PerlinNoise(std::vector<std::pair<double, double>> positions, NoiseParameters parameters) noexcept;
+//Octave noise at each position, rescaled into [-1, 1].
+//Ranges of positions go across the pool if there is one. Within a range each octave runs in stages over blocks of positions
+//(scaled coordinates, fades, lattice values and interpolation), fades are remembered per coordinate and lattice values per cell.
+//Every position still gets exactly Noise2D's arithmetic in octave order, so a seed gives the same table bit for bit, whatever the thread count
+std::vector<double> PerlinNoise(const std::vector<std::pair<double, double>> &positions, NoiseParameters parameters, my::WorkerPool *pool = nullptr) noexcept;
 
 }//namespace noise
 }//namespace pleistocene
\ No newline at end of file
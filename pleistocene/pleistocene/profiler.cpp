@@ -0,0 +1,186 @@
+#include "profiler.h"
+#include <iomanip>
+
+namespace pleistocene {
+namespace my {
+
+//======================================
+//HISTOGRAM
+//======================================
+
+void TimingHistogram::record(double seconds) noexcept
+{
+	if (int(_window.size()) == kWindow) {
+		_windowSeconds -= _window.front();
+		_buckets[bucketOf(_window.front())]--;
+		_window.pop_front();
+	}
+
+	_window.push_back(seconds);
+	_buckets[bucketOf(seconds)]++;
+	_windowSeconds += seconds;
+
+	_totalCount++;
+	_totalSeconds += seconds;
+}
+
+double TimingHistogram::last() const noexcept { return _window.empty() ? 0 : _window.back(); }
+
+double TimingHistogram::mean() const noexcept { return _window.empty() ? 0 : _windowSeconds / _window.size(); }
+
+double TimingHistogram::max() const noexcept
+{
+	return _window.empty() ? 0 : *std::max_element(_window.begin(), _window.end());
+}
+
+double TimingHistogram::percentile(double fraction) const noexcept
+{
+	int needed = int(ceil(fraction * _window.size()));
+	int seen = 0;
+	for (int bucket = 0; bucket < kBuckets; bucket++) {
+		seen += _buckets[bucket];
+		if (seen >= needed && seen > 0) return std::min(bucketUpperEdge(bucket), max());
+	}
+	return 0;
+}
+
+int TimingHistogram::windowCount() const noexcept { return int(_window.size()); }
+
+long long TimingHistogram::totalCount() const noexcept { return _totalCount; }
+
+double TimingHistogram::totalSeconds() const noexcept { return _totalSeconds; }
+
+const std::array<int, TimingHistogram::kBuckets> &TimingHistogram::buckets() const noexcept { return _buckets; }
+
+std::string TimingHistogram::sparkline() const noexcept
+{
+	static const std::string kLevels = " .:-=+*#";
+
+	int fullest = *std::max_element(_buckets.begin(), _buckets.end());
+
+	//only the span of buckets that have samples
+	int first = 0, lastBucket = kBuckets - 1;
+	while (first < kBuckets && _buckets[first] == 0) first++;
+	while (lastBucket > first && _buckets[lastBucket] == 0) lastBucket--;
+
+	std::string line;
+	for (int bucket = first; bucket <= lastBucket; bucket++) {
+		int level = (_buckets[bucket] == 0) ? 0 : 1 + (_buckets[bucket] * (int(kLevels.size()) - 2)) / fullest;
+		line += kLevels[level];
+	}
+	return line;
+}
+
+int TimingHistogram::bucketOf(double seconds) noexcept
+{
+	double microseconds = seconds * 1e6;
+	int bucket = 0;
+	while (microseconds >= 2 && bucket < kBuckets - 1) {
+		microseconds /= 2;
+		bucket++;
+	}
+	return bucket;
+}
+
+double TimingHistogram::bucketUpperEdge(int bucket) noexcept { return pow(2, bucket + 1) * 1e-6; }
+
+//======================================
+//PROFILER
+//======================================
+
+std::mutex Profiler::_mutex;
+std::vector<std::pair<std::string, TimingHistogram>> Profiler::_sections;
+
+void Profiler::record(const std::string &section, double seconds) noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (auto &entry : _sections) {
+		if (entry.first == section) {
+			entry.second.record(seconds);
+			return;
+		}
+	}
+
+	_sections.emplace_back(section, TimingHistogram());
+	_sections.back().second.record(seconds);
+}
+
+std::vector<std::string> Profiler::getMessages() noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::vector<std::string> messages;
+	messages.push_back("Profile (ms): last mean p95 max");
+
+	for (auto &entry : _sections) {
+		const TimingHistogram &histogram = entry.second;
+		std::stringstream stream;
+		stream << std::fixed << std::setprecision(2);
+		stream << entry.first << ": " << histogram.last() * 1e3 << " " << histogram.mean() * 1e3 << " "
+			<< histogram.percentile(0.95) * 1e3 << " " << histogram.max() * 1e3;
+		messages.push_back(stream.str());
+		messages.push_back("  [" + histogram.sparkline() + "]");
+	}
+	return messages;
+}
+
+std::vector<std::pair<std::string, double>> Profiler::lastSamples(const std::string &prefix) noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::vector<std::pair<std::string, double>> samples;
+	for (auto &entry : _sections) {
+		if (entry.first.compare(0, prefix.size(), prefix) == 0) {
+			samples.emplace_back(entry.first, entry.second.last());
+		}
+	}
+	return samples;
+}
+
+bool Profiler::dump(const std::string &path) noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	std::ofstream file(path);
+	if (!file) { LOG("Could not open " << path << " for the profile"); return false; }
+
+	file << "pleistocene profile\n";
+	file << "window " << TimingHistogram::kWindow << " samples, times in ms, bucket b counts samples in [2^b, 2^(b+1)) us\n";
+	file << "section\tcalls\ttotal\tmean\tp50\tp95\tmax";
+	for (int bucket = 0; bucket < TimingHistogram::kBuckets; bucket++) {
+		file << "\tb" << bucket;
+	}
+	file << "\n";
+
+	for (auto &entry : _sections) {
+		const TimingHistogram &histogram = entry.second;
+		file << entry.first << "\t" << histogram.totalCount() << "\t" << histogram.totalSeconds() * 1e3
+			<< "\t" << histogram.mean() * 1e3 << "\t" << histogram.percentile(0.5) * 1e3
+			<< "\t" << histogram.percentile(0.95) * 1e3 << "\t" << histogram.max() * 1e3;
+		for (int count : histogram.buckets()) {
+			file << "\t" << count;
+		}
+		file << "\n";
+	}
+
+	if (!file) { LOG("Could not write the profile to " << path); return false; }
+	return true;
+}
+
+//======================================
+//SCOPED TIMER
+//======================================
+
+ScopedTimer::ScopedTimer(const std::string &section) noexcept :
+_section(section),
+_start(std::chrono::steady_clock::now())
+{}
+
+ScopedTimer::~ScopedTimer() noexcept
+{
+	Profiler::record(_section, std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count());
+}
+
+}//namespace my
+}//namespace pleistocene
@@ -0,0 +1,81 @@
+#pragma once
+#include "globals.h"
+#include <chrono>
+#include <mutex>
+#include <array>
+#include <deque>
+
+namespace pleistocene {
+namespace my {
+
+//Wall time of the most recent kWindow samples of one section, in power of two buckets
+//(bucket 0 is under 2 microseconds, bucket b covers [2^b, 2^(b+1)) microseconds)
+class TimingHistogram {
+public:
+	static const int kWindow = 256;
+	static const int kBuckets = 24;//top bucket catches everything over ~8 s
+
+	void record(double seconds) noexcept;
+
+	//window statistics, in seconds
+	double last() const noexcept;
+	double mean() const noexcept;
+	double max() const noexcept;
+	double percentile(double fraction) const noexcept;//upper edge of the bucket holding that fraction of samples (at most max())
+
+	int windowCount() const noexcept;
+	long long totalCount() const noexcept;
+	double totalSeconds() const noexcept;
+	const std::array<int, kBuckets> &buckets() const noexcept;
+
+	//one character per bucket, scaled to the fullest bucket
+	std::string sparkline() const noexcept;
+
+	static int bucketOf(double seconds) noexcept;
+	static double bucketUpperEdge(int bucket) noexcept;
+
+private:
+	std::deque<double> _window;
+	std::array<int, kBuckets> _buckets{};
+	double _windowSeconds = 0;
+	long long _totalCount = 0;
+	double _totalSeconds = 0;
+};
+
+//Named wall-time sections (simulation steps, statistics, drawing, frame phases) shown in the Bios profile panel
+//and dumped to a file on exit. Sections are listed in the order they were first recorded.
+//record() is cheap enough for per-step and per-frame sections but is not meant for per-tile work.
+class Profiler {
+public:
+	static void record(const std::string &section, double seconds) noexcept;
+
+	//one line per section: last, mean, p95, max (ms) and the window histogram
+	static std::vector<std::string> getMessages() noexcept;
+
+	//the last sample (s) of each section whose name starts with prefix, e.g. the world build stages
+	static std::vector<std::pair<std::string, double>> lastSamples(const std::string &prefix) noexcept;
+
+	//text table of every section with its bucket counts. false (and LOG) on failure
+	static bool dump(const std::string &path) noexcept;
+
+private:
+	static std::mutex _mutex;
+	static std::vector<std::pair<std::string, TimingHistogram>> _sections;
+};
+
+//records the wall time of its own lifetime
+class ScopedTimer {
+public:
+	ScopedTimer(const std::string &section) noexcept;
+	~ScopedTimer() noexcept;
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+	std::string _section;
+	std::chrono::steady_clock::time_point _start;
+};
+
+}//namespace my
+}//namespace pleistocene
@@ -0,0 +1,62 @@
+#include "radiation-kernels.h"
+
+//compiled with AVX2 enabled (CMakeLists.txt, pleistocene.vcxproj). a build without it leaves this variant out
+#if defined(__AVX2__)
+#include "radiation-kernels-impl.h"
+#include <immintrin.h>
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+namespace {
+
+struct Avx2Pack {
+	typedef __m256d Value;
+	typedef __m256d Mask;
+	static const int kWidth = 4;
+
+	static Value load(const double *source) noexcept { return _mm256_loadu_pd(source); }
+	static void store(double *destination, Value a) noexcept { _mm256_storeu_pd(destination, a); }
+	static Value set(double a) noexcept { return _mm256_set1_pd(a); }
+
+	static Value add(Value a, Value b) noexcept { return _mm256_add_pd(a, b); }
+	static Value sub(Value a, Value b) noexcept { return _mm256_sub_pd(a, b); }
+	static Value mul(Value a, Value b) noexcept { return _mm256_mul_pd(a, b); }
+	static Value div(Value a, Value b) noexcept { return _mm256_div_pd(a, b); }
+	static Value sqrt(Value a) noexcept { return _mm256_sqrt_pd(a); }
+	static Value abs(Value a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+	static Mask greater(Value a, Value b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+	static Mask lessEqual(Value a, Value b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+	static Mask allLanes() noexcept { return _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); }
+	static Mask andNot(Mask a, Mask b) noexcept { return _mm256_andnot_pd(b, a); }
+	static bool any(Mask a) noexcept { return _mm256_movemask_pd(a) != 0; }
+	static Value select(Mask mask, Value a, Value b) noexcept { return _mm256_blendv_pd(b, a, mask); }
+};
+
+}//namespace
+
+const RadiationKernels *avx2RadiationKernels() noexcept
+{
+	static const RadiationKernels kernels = makeRadiationKernels<Avx2Pack>(AVX2_RADIATION);
+	return &kernels;
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
+
+#else
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+const RadiationKernels *avx2RadiationKernels() noexcept { return nullptr; }
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
+
+#endif
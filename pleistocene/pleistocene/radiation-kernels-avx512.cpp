@@ -0,0 +1,62 @@
+#include "radiation-kernels.h"
+
+//compiled with AVX-512F enabled (CMakeLists.txt, pleistocene.vcxproj). a build without it leaves this variant out
+#if defined(__AVX512F__)
+#include "radiation-kernels-impl.h"
+#include <immintrin.h>
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+namespace {
+
+struct Avx512Pack {
+	typedef __m512d Value;
+	typedef __mmask8 Mask;
+	static const int kWidth = 8;
+
+	static Value load(const double *source) noexcept { return _mm512_loadu_pd(source); }
+	static void store(double *destination, Value a) noexcept { _mm512_storeu_pd(destination, a); }
+	static Value set(double a) noexcept { return _mm512_set1_pd(a); }
+
+	static Value add(Value a, Value b) noexcept { return _mm512_add_pd(a, b); }
+	static Value sub(Value a, Value b) noexcept { return _mm512_sub_pd(a, b); }
+	static Value mul(Value a, Value b) noexcept { return _mm512_mul_pd(a, b); }
+	static Value div(Value a, Value b) noexcept { return _mm512_div_pd(a, b); }
+	static Value sqrt(Value a) noexcept { return _mm512_sqrt_pd(a); }
+	static Value abs(Value a) noexcept { return _mm512_abs_pd(a); }
+
+	static Mask greater(Value a, Value b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+	static Mask lessEqual(Value a, Value b) noexcept { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+	static Mask allLanes() noexcept { return Mask(0xFF); }
+	static Mask andNot(Mask a, Mask b) noexcept { return Mask(a & ~b); }
+	static bool any(Mask a) noexcept { return a != 0; }
+	static Value select(Mask mask, Value a, Value b) noexcept { return _mm512_mask_blend_pd(mask, b, a); }
+};
+
+}//namespace
+
+const RadiationKernels *avx512RadiationKernels() noexcept
+{
+	static const RadiationKernels kernels = makeRadiationKernels<Avx512Pack>(AVX512_RADIATION);
+	return &kernels;
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
+
+#else
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+const RadiationKernels *avx512RadiationKernels() noexcept { return nullptr; }
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
+
+#endif
@@ -0,0 +1,208 @@
+#pragma once
+#include "radiation-kernels.h"
+#include <cmath>
+
+//Kernel bodies of the radiation-kernels*.cpp variants, include from those only.
+//Everything here has internal linkage: each variant's translation unit is compiled for its own instruction set,
+//and the linker must never swap one copy for another.
+//A Pack supplies the lane type (Value), comparison results (Mask), its width and the arithmetic, see ScalarPack
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+namespace {
+
+struct ScalarPack {
+	typedef double Value;
+	typedef bool Mask;
+	static const int kWidth = 1;
+
+	static Value load(const double *source) noexcept { return *source; }
+	static void store(double *destination, Value a) noexcept { *destination = a; }
+	static Value set(double a) noexcept { return a; }
+
+	static Value add(Value a, Value b) noexcept { return a + b; }
+	static Value sub(Value a, Value b) noexcept { return a - b; }
+	static Value mul(Value a, Value b) noexcept { return a * b; }
+	static Value div(Value a, Value b) noexcept { return a / b; }
+	static Value sqrt(Value a) noexcept { return std::sqrt(a); }
+	static Value abs(Value a) noexcept { return std::fabs(a); }
+
+	static Mask greater(Value a, Value b) noexcept { return a > b; }
+	static Mask lessEqual(Value a, Value b) noexcept { return a <= b; }
+	static Mask allLanes() noexcept { return true; }
+	//a and not b
+	static Mask andNot(Mask a, Mask b) noexcept { return a && !b; }
+	static bool any(Mask a) noexcept { return a; }
+	//a where mask, else b
+	static Value select(Mask mask, Value a, Value b) noexcept { return mask ? a : b; }
+};
+
+//Mixture::filterSolarRadiation. unlit entries are left alone
+template<class Pack>
+inline void filterSolarLanes(const RadiationBatch &batch, double *energy, int i) noexcept
+{
+	typedef typename Pack::Value Value;
+	typedef typename Pack::Mask Mask;
+
+	Value incoming = Pack::load(energy + i);
+	Mask lit = Pack::greater(incoming, Pack::set(0));
+
+	//reflection
+	Value entering = Pack::mul(incoming, Pack::sub(Pack::set(1), Pack::load(batch.albedo + i)));
+	Value absorbed = Pack::mul(Pack::load(batch.solarAbsorptionIndex + i), entering);
+	Pack::store(energy + i, Pack::select(lit, Pack::sub(entering, absorbed), Pack::set(0)));
+
+	Pack::store(batch.solarInput + i, Pack::select(lit, absorbed, Pack::load(batch.solarInput + i)));
+
+	Value temperature = Pack::load(batch.temperature + i);
+	Value warmed = Pack::add(temperature, Pack::div(absorbed, Pack::load(batch.heatCapacity + i)));
+	Mask warms = Pack::andNot(lit, Pack::greater(Pack::load(batch.emittor + i), Pack::set(0.5)));
+	Pack::store(batch.temperature + i, Pack::select(warms, warmed, temperature));
+}
+
+//Mixture::filterInfrared
+template<class Pack>
+inline void filterInfraredLanes(const RadiationBatch &batch, double *energy, int i) noexcept
+{
+	typedef typename Pack::Value Value;
+
+	Value incoming = Pack::load(energy + i);
+	Value absorbed = Pack::mul(Pack::load(batch.infraredAbsorptionIndex + i), incoming);
+	Pack::store(energy + i, Pack::sub(incoming, absorbed));
+
+	Pack::store(batch.infraredInput + i, Pack::add(Pack::load(batch.infraredInput + i), absorbed));
+	Pack::store(batch.infraredInputDisplay + i, Pack::add(Pack::load(batch.infraredInputDisplay + i), absorbed));
+
+	Value temperature = Pack::load(batch.temperature + i);
+	Value warmed = Pack::add(temperature, Pack::div(absorbed, Pack::load(batch.heatCapacity + i)));
+	Pack::store(batch.temperature + i, Pack::select(Pack::greater(Pack::load(batch.emittor + i), Pack::set(0.5)), temperature, warmed));
+}
+
+//Mixture::calculateEquilibriumTemperature, (input / c)^(1/4)
+template<class Pack>
+inline typename Pack::Value equilibriumLanes(typename Pack::Value input, typename Pack::Value emissionPerT4) noexcept
+{
+	return Pack::sqrt(Pack::sqrt(Pack::div(input, emissionPerT4)));
+}
+
+//Mixture::handleInOutRadiation, EXPLICIT_RADIATION
+template<class Pack>
+inline void emitExplicitLanes(const RadiationBatch &batch, double *emitted, int i) noexcept
+{
+	typedef typename Pack::Value Value;
+	typedef typename Pack::Mask Mask;
+
+	Value temperature = Pack::load(batch.temperature + i);
+	Value heatCapacity = Pack::load(batch.heatCapacity + i);
+	Value emissionPerT4 = Pack::load(batch.emissionPerT4 + i);
+	Value input = Pack::add(Pack::load(batch.infraredInput + i), Pack::load(batch.solarInput + i));
+
+	Value equilibrium = equilibriumLanes<Pack>(input, emissionPerT4);
+	Pack::store(batch.equilibriumTemperature + i, equilibrium);
+
+	Value postInput = Pack::add(temperature, Pack::div(input, heatCapacity));
+	Pack::store(batch.infraredInput + i, Pack::set(0));
+
+	Value square = Pack::mul(temperature, temperature);
+	Value preEmissions = Pack::mul(emissionPerT4, Pack::mul(square, square));
+	Value postInputOutput = Pack::sub(postInput, Pack::div(preEmissions, heatCapacity));
+
+	//cooling, or warming short of equilibrium, emits preEmissions. overwarming stops at equilibrium and emits the excess
+	Mask overWarming = Pack::andNot(Pack::greater(postInputOutput, equilibrium), Pack::greater(temperature, equilibrium));
+	Value excess = Pack::mul(Pack::sub(postInputOutput, equilibrium), heatCapacity);
+
+	Value output = Pack::select(overWarming, Pack::add(preEmissions, excess), preEmissions);
+	Pack::store(batch.temperature + i, Pack::select(overWarming, equilibrium, postInputOutput));
+	Pack::store(batch.outputRadiation + i, output);
+	Pack::store(emitted + i, output);
+}
+
+//Mixture::radiateImplicit. lanes stop updating once they converge, so each follows the scalar iteration exactly
+template<class Pack>
+inline void emitImplicitLanes(const RadiationBatch &batch, double *emitted, int i) noexcept
+{
+	typedef typename Pack::Value Value;
+	typedef typename Pack::Mask Mask;
+
+	const int kMaxIterations = 8;
+	const double kTolerance = 1e-12;//relative
+
+	Value startTemperature = Pack::load(batch.temperature + i);
+	Value heatCapacity = Pack::load(batch.heatCapacity + i);
+	Value emissionPerT4 = Pack::load(batch.emissionPerT4 + i);
+	Value input = Pack::add(Pack::load(batch.infraredInput + i), Pack::load(batch.solarInput + i));
+
+	Pack::store(batch.equilibriumTemperature + i, equilibriumLanes<Pack>(input, emissionPerT4));
+	Pack::store(batch.infraredInput + i, Pack::set(0));
+
+	Value endTemperature = startTemperature;
+	Mask active = Pack::allLanes();
+
+	for (int iteration = 0; iteration < kMaxIterations && Pack::any(active); iteration++) {
+		Value cube = Pack::mul(Pack::mul(endTemperature, endTemperature), endTemperature);
+		Value residual = Pack::add(Pack::sub(Pack::mul(heatCapacity, Pack::sub(endTemperature, startTemperature)), input),
+			Pack::mul(Pack::mul(emissionPerT4, cube), endTemperature));
+		Value slope = Pack::add(heatCapacity, Pack::mul(Pack::mul(Pack::set(4), emissionPerT4), cube));
+		Value correction = Pack::div(residual, slope);
+
+		Value next = Pack::sub(endTemperature, correction);
+		endTemperature = Pack::select(active, next, endTemperature);
+		active = Pack::andNot(active, Pack::lessEqual(Pack::abs(correction), Pack::mul(Pack::set(kTolerance), next)));
+	}
+
+	Value output = Pack::sub(input, Pack::mul(heatCapacity, Pack::sub(endTemperature, startTemperature)));
+	Pack::store(batch.temperature + i, endTemperature);
+	Pack::store(batch.outputRadiation + i, output);
+	Pack::store(emitted + i, output);
+}
+
+//full packs, then the remainder one entry at a time (the same operations, so the same results)
+template<class Pack>
+void filterSolarKernel(const RadiationBatch &batch, double *energy) noexcept
+{
+	int i = 0;
+	for (; i + Pack::kWidth <= batch.count; i += Pack::kWidth) filterSolarLanes<Pack>(batch, energy, i);
+	for (; i < batch.count; i++) filterSolarLanes<ScalarPack>(batch, energy, i);
+}
+
+template<class Pack>
+void filterInfraredKernel(const RadiationBatch &batch, double *energy) noexcept
+{
+	int i = 0;
+	for (; i + Pack::kWidth <= batch.count; i += Pack::kWidth) filterInfraredLanes<Pack>(batch, energy, i);
+	for (; i < batch.count; i++) filterInfraredLanes<ScalarPack>(batch, energy, i);
+}
+
+template<class Pack>
+void emitExplicitKernel(const RadiationBatch &batch, double *emitted) noexcept
+{
+	int i = 0;
+	for (; i + Pack::kWidth <= batch.count; i += Pack::kWidth) emitExplicitLanes<Pack>(batch, emitted, i);
+	for (; i < batch.count; i++) emitExplicitLanes<ScalarPack>(batch, emitted, i);
+}
+
+template<class Pack>
+void emitImplicitKernel(const RadiationBatch &batch, double *emitted) noexcept
+{
+	int i = 0;
+	for (; i + Pack::kWidth <= batch.count; i += Pack::kWidth) emitImplicitLanes<Pack>(batch, emitted, i);
+	for (; i < batch.count; i++) emitImplicitLanes<ScalarPack>(batch, emitted, i);
+}
+
+template<class Pack>
+RadiationKernels makeRadiationKernels(RadiationIsa isa) noexcept
+{
+	RadiationKernels kernels;
+	kernels.isa = isa;
+	kernels.filterSolar = filterSolarKernel<Pack>;
+	kernels.filterInfrared = filterInfraredKernel<Pack>;
+	kernels.emitExplicit = emitExplicitKernel<Pack>;
+	kernels.emitImplicit = emitImplicitKernel<Pack>;
+	return kernels;
+}
+
+}//namespace
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
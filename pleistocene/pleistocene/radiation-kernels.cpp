@@ -0,0 +1,82 @@
+#include "radiation-kernels.h"
+#include "radiation-kernels-impl.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+namespace {
+
+//instruction set and operating system support (the wide registers must be saved on context switches)
+bool cpuSupports(RadiationIsa isa) noexcept
+{
+	if (isa == SCALAR_RADIATION) return true;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if (isa == AVX2_RADIATION) return __builtin_cpu_supports("avx2");
+	return __builtin_cpu_supports("avx512f");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27))) return false;//no XGETBV
+	unsigned long long enabledState = _xgetbv(0);
+
+	__cpuidex(info, 7, 0);
+	if (isa == AVX2_RADIATION) return (enabledState & 0x6) == 0x6 && (info[1] & (1 << 5));
+	return (enabledState & 0xE6) == 0xE6 && (info[1] & (1 << 16));
+#else
+	return false;
+#endif
+}
+
+const RadiationKernels &bestRadiationKernels() noexcept
+{
+	for (RadiationIsa isa : { AVX512_RADIATION, AVX2_RADIATION }) {
+		const RadiationKernels *kernels = radiationKernels(isa);
+		if (kernels) return *kernels;
+	}
+	return *scalarRadiationKernels();
+}
+
+}//namespace
+
+const RadiationKernels *scalarRadiationKernels() noexcept
+{
+	static const RadiationKernels kernels = makeRadiationKernels<ScalarPack>(SCALAR_RADIATION);
+	return &kernels;
+}
+
+const RadiationKernels *radiationKernels(RadiationIsa isa) noexcept
+{
+	if (!cpuSupports(isa)) return nullptr;
+
+	switch (isa) {
+	case(AVX512_RADIATION) : return avx512RadiationKernels();
+	case(AVX2_RADIATION) : return avx2RadiationKernels();
+	default: return scalarRadiationKernels();
+	}
+}
+
+const RadiationKernels &radiationKernels() noexcept
+{
+	static const RadiationKernels &kernels = bestRadiationKernels();
+	return kernels;
+}
+
+const char *radiationIsaName(RadiationIsa isa) noexcept
+{
+	switch (isa) {
+	case(AVX512_RADIATION) : return "avx512";
+	case(AVX2_RADIATION) : return "avx2";
+	default: return "scalar";
+	}
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
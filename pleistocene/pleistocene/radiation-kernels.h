@@ -0,0 +1,65 @@
+#pragma once
+#include "globals.h"
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+//Layers of a batched radiation pass, one array entry per layer.
+//Padding entries (heat capacity 1, temperature 0, emission coefficient 1, no absorption) absorb and emit nothing and stay put
+struct RadiationBatch {
+	double *temperature;
+	double *solarInput;
+	double *infraredInput;
+	double *infraredInputDisplay;
+	double *outputRadiation;
+	double *equilibriumTemperature;
+
+	const double *heatCapacity;
+	const double *albedo;
+	const double *solarAbsorptionIndex;
+	const double *emissionPerT4;//Mixture::calculateEmissions(gas, mass, 1) for the current step
+	const double *infraredAbsorptionIndex;
+	const double *emittor;//1 for emittors, which don't warm from what they absorb, else 0
+
+	int count;
+};
+
+enum RadiationIsa {
+	SCALAR_RADIATION,
+	AVX2_RADIATION,
+	AVX512_RADIATION
+};
+
+//Mixture::filterSolarRadiation, filterInfrared and emitInfrared over a RadiationBatch.
+//One kernel body (radiation-kernels-impl.h) is compiled for each instruction set, each in its own translation unit
+//built with that instruction set enabled. Every variant does the same IEEE operations per entry, so they agree bit for bit.
+//Against the Mixture path: absorption and the implicit Newton solve match exactly, but emission is evaluated as
+//c*(T*T)*(T*T) and the equilibrium temperature as sqrt(sqrt(x)) rather than with pow, a few ulp apart
+struct RadiationKernels {
+	RadiationIsa isa;
+	//energy[i] of sunlight passes through entry i: the absorbed part is booked, the rest written back (0 if none came in)
+	void(*filterSolar)(const RadiationBatch &batch, double *energy);
+	//energy[i] passes through entry i: the absorbed part is booked, the rest written back
+	void(*filterInfrared)(const RadiationBatch &batch, double *energy);
+	//EXPLICIT_RADIATION and IMPLICIT_RADIATION. emitted[i] is entry i's output radiation
+	void(*emitExplicit)(const RadiationBatch &batch, double *emitted);
+	void(*emitImplicit)(const RadiationBatch &batch, double *emitted);
+};
+
+//the widest variant this build has and the CPU supports, chosen on first use
+const RadiationKernels &radiationKernels() noexcept;
+
+//each variant, nullptr if this build or CPU lacks it
+const RadiationKernels *radiationKernels(RadiationIsa isa) noexcept;
+
+const char *radiationIsaName(RadiationIsa isa) noexcept;
+
+//defined by the per instruction set translation units, nullptr when compiled without it
+const RadiationKernels *scalarRadiationKernels() noexcept;
+const RadiationKernels *avx2RadiationKernels() noexcept;
+const RadiationKernels *avx512RadiationKernels() noexcept;
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
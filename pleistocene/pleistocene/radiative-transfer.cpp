@@ -0,0 +1,273 @@
+#include "radiative-transfer.h"
+#include "tile-climate.h"
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+using layers::elements::Mixture;
+
+//======================================
+//RADIATION LEVELS
+//======================================
+
+void RadiationLevels::build(int levelCount, int tileCount) noexcept
+{
+	levels = levelCount;
+	int n = levels*tileCount;
+
+	LayerSlot padding;
+	padding.type = layers::EARTH;
+	padding.index = my::kFakeIndex;
+	slots.assign(n, padding);
+
+	temperature.assign(n, 0);
+	solarInput.assign(n, 0);
+	infraredInput.assign(n, 0);
+	infraredInputDisplay.assign(n, 0);
+	outputRadiation.assign(n, 0);
+	equilibriumTemperature.assign(n, 0);
+	heatCapacity.assign(n, 1);
+	albedo.assign(n, 0);
+	solarAbsorptionIndex.assign(n, 0);
+	emissionPerT4.assign(n, 1);
+	infraredAbsorptionIndex.assign(n, 0);
+	emittor.assign(n, 0);
+}
+
+RadiationBatch RadiationLevels::batch(int level, int tileCount, int beginTile, int endTile) noexcept
+{
+	int k = level*tileCount + beginTile;
+
+	RadiationBatch batch;
+	batch.temperature = temperature.data() + k;
+	batch.solarInput = solarInput.data() + k;
+	batch.infraredInput = infraredInput.data() + k;
+	batch.infraredInputDisplay = infraredInputDisplay.data() + k;
+	batch.outputRadiation = outputRadiation.data() + k;
+	batch.equilibriumTemperature = equilibriumTemperature.data() + k;
+	batch.heatCapacity = heatCapacity.data() + k;
+	batch.albedo = albedo.data() + k;
+	batch.solarAbsorptionIndex = solarAbsorptionIndex.data() + k;
+	batch.emissionPerT4 = emissionPerT4.data() + k;
+	batch.infraredAbsorptionIndex = infraredAbsorptionIndex.data() + k;
+	batch.emittor = emittor.data() + k;
+	batch.count = endTile - beginTile;
+
+	return batch;
+}
+
+//======================================
+//INITIALIZATION
+//======================================
+
+void RadiativeTransfer::build(const std::vector<int> &columnOffsets, const std::vector<LayerSlot> &columnSlots,
+	const std::vector<LayerSlot> &surfaceSlots, const std::vector<int> &airBegin, const std::vector<int> &airEnd) noexcept
+{
+	_tileCount = int(surfaceSlots.size());
+
+	_solarEnergy.assign(_tileCount, 0);
+	_columnHeights.assign(_tileCount, 0);
+
+	int solarLevels = 0;
+	for (int tile = 0; tile < _tileCount; tile++) {
+		_columnHeights[tile] = columnOffsets[tile + 1] - columnOffsets[tile];
+		solarLevels = std::max(solarLevels, _columnHeights[tile]);
+	}
+
+	_solar.build(solarLevels, _tileCount);
+	for (int tile = 0; tile < _tileCount; tile++) {
+		for (int level = 0; level < _columnHeights[tile]; level++) {
+			_solar.slots[level*_tileCount + tile] = columnSlots[columnOffsets[tile + 1] - 1 - level];
+		}
+	}
+
+	_infrared.build(1 + layers::air::kMaxAirLayers, _tileCount);
+	for (int tile = 0; tile < _tileCount; tile++) {
+		_infrared.slots[tile] = surfaceSlots[tile];
+		for (int j = 0; j < airEnd[tile] - airBegin[tile]; j++) {
+			_infrared.slots[(1 + j)*_tileCount + tile] = LayerSlot{ layers::AIR, airBegin[tile] + j };
+		}
+	}
+
+	_downRadiation.assign(layers::air::kMaxAirLayers*_tileCount, 0);
+	_upRadiation.assign(_tileCount, 0);
+	_emitted.assign(_tileCount, 0);
+	_energy.assign(_tileCount, 0);
+	_lit.assign(_tileCount, 0);
+}
+
+void RadiativeTransfer::setSolarEnergy(int tile, double energyKJ) noexcept { _solarEnergy[tile] = energyKJ; }
+
+//======================================
+//SIMULATION
+//======================================
+
+//TileClimate step 1 after beginNewHour: sunlight down the columns, then infrared up and back down
+void RadiativeTransfer::simulate(LayerArrays *layers, int beginTile, int endTile,
+	std::vector<double> &backRadiation, std::vector<double> &escapeRadiation) noexcept
+{
+	filterSolar(layers, beginTile, endTile);
+	simulateInfrared(layers, beginTile, endTile, backRadiation, escapeRadiation);
+}
+
+//MaterialColumn::filterSolarRadiation, level l being the l-th layer from the top of each column.
+//Only lit lanes are gathered and written back; the rest pass 0 energy through the kernel untouched
+void RadiativeTransfer::filterSolar(LayerArrays *layers, int beginTile, int endTile) noexcept
+{
+	int count = endTile - beginTile;
+	const RadiationKernels &kernels = radiationKernels();
+
+	double *energy = _energy.data() + beginTile;
+	for (int t = 0; t < count; t++) {
+		energy[t] = 3 * std::max(_solarEnergy[beginTile + t], 0.0);//the stratosphere absorbs for three
+	}
+
+	for (int level = 0; level < _solar.levels; level++) {
+		bool lit = false;
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			_lit[tile] = (_energy[tile] > 0);
+			if (!_lit[tile]) continue;
+			lit = true;
+
+			int k = level*_tileCount + tile;
+			LayerSlot slot = _solar.slots[k];
+			const LayerArrays &layer = layers[slot.type];
+			int i = slot.index;
+
+			if (layer.heatCapacity[i] <= 0) { LOG("ZERO HEAT CAPACITY"); exit(EXIT_FAILURE); }
+			if (layer.albedo[i] < 0 || layer.albedo[i]>1) { LOG("WEIRD ALBEDO"); exit(EXIT_FAILURE); }
+
+			_solar.temperature[k] = layer.temperature[i];
+			_solar.solarInput[k] = layer.hourlySolarInput[i];
+			_solar.heatCapacity[k] = layer.heatCapacity[i];
+			_solar.albedo[k] = layer.albedo[i];
+			_solar.solarAbsorptionIndex[k] = layer.solarAbsorptionIndex[i];
+			_solar.emittor[k] = layer.emittor[i] ? 1 : 0;
+		}
+		if (!lit) break;
+
+		kernels.filterSolar(_solar.batch(level, _tileCount, beginTile, endTile), energy);
+
+		for (int tile = beginTile; tile < endTile; tile++) {
+			if (!_lit[tile]) continue;
+
+			int k = level*_tileCount + tile;
+			LayerSlot slot = _solar.slots[k];
+			LayerArrays &layer = layers[slot.type];
+			int i = slot.index;
+
+			layer.temperature[i] = _solar.temperature[k];
+			layer.hourlySolarInput[i] = _solar.solarInput[k];
+
+			if (level == 0) _energy[tile] /= 3;
+
+			//don't send down less than a joule
+			if (_energy[tile] <= 0.001) { _energy[tile] = 0; continue; }
+
+			if (level + 1 == _columnHeights[tile]) { LOG("Sun to bedrock?"); exit(EXIT_FAILURE); }
+		}
+	}
+}
+
+//MaterialColumn::simulateInfraredRadiation: the same passes up and down the columns, each level of every column at once
+void RadiativeTransfer::simulateInfrared(LayerArrays *layers, int beginTile, int endTile,
+	std::vector<double> &backRadiation, std::vector<double> &escapeRadiation) noexcept
+{
+	int count = endTile - beginTile;
+	RadiationLevels &levels = _infrared;
+
+	const RadiationKernels &kernels = radiationKernels();
+	auto emit = (TileClimate::getRadiationScheme() == IMPLICIT_RADIATION) ? kernels.emitImplicit : kernels.emitExplicit;
+
+	for (int level = 0; level < levels.levels; level++) {
+		for (int tile = beginTile; tile < endTile; tile++) {
+			int k = level*_tileCount + tile;
+			LayerSlot slot = levels.slots[k];
+			if (slot.index == my::kFakeIndex) continue;
+
+			const LayerArrays &layer = layers[slot.type];
+			int i = slot.index;
+
+			if (layer.heatCapacity[i] <= 0) { LOG("ZERO HEAT CAPACITY"); exit(EXIT_FAILURE); }
+			if (layer.temperature[i] <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+
+			levels.temperature[k] = layer.temperature[i];
+			levels.infraredInput[k] = layer.hourlyInfraredInput[i];
+			levels.infraredInputDisplay[k] = layer.hourlyInfraredInputDisplay[i];
+			levels.solarInput[k] = layer.hourlySolarInput[i];
+			levels.heatCapacity[k] = layer.heatCapacity[i];
+			levels.emissionPerT4[k] = Mixture::calculateEmissions(layer.gas[i] != 0, layer.mass[i], 1.0);
+			levels.infraredAbsorptionIndex[k] = layer.infraredAbsorptionIndex[i];
+			levels.emittor[k] = layer.emittor[i] ? 1 : 0;
+		}
+	}
+
+	double *upRadiation = _upRadiation.data() + beginTile;
+	double *emitted = _emitted.data() + beginTile;
+	double *energy = _energy.data() + beginTile;
+
+	RadiationBatch surface = levels.batch(0, _tileCount, beginTile, endTile);
+	emit(surface, upRadiation);
+
+	//filter/emit upwards
+	for (int j = 0; j < layers::air::kMaxAirLayers; j++) {
+		RadiationBatch air = levels.batch(1 + j, _tileCount, beginTile, endTile);
+		double *downRadiation = _downRadiation.data() + j*_tileCount + beginTile;
+
+		kernels.filterInfrared(air, upRadiation);
+		emit(air, emitted);
+
+		for (int t = 0; t < count; t++) {
+			downRadiation[t] = emitted[t] / 2.0;
+			upRadiation[t] += emitted[t] / 2.0;
+		}
+	}
+
+	for (int t = 0; t < count; t++) {
+		escapeRadiation[beginTile + t] = upRadiation[t];
+	}
+
+	//filter downwards. above a column's top air layer everything is 0, which passes through unchanged
+	for (int j = layers::air::kMaxAirLayers - 2; j >= 0; j--) {
+		RadiationBatch air = levels.batch(1 + j, _tileCount, beginTile, endTile);
+		const double *aboveRadiation = _downRadiation.data() + (j + 1)*_tileCount + beginTile;
+		double *downRadiation = _downRadiation.data() + j*_tileCount + beginTile;
+
+		std::copy(aboveRadiation, aboveRadiation + count, energy);
+		kernels.filterInfrared(air, energy);
+
+		for (int t = 0; t < count; t++) {
+			downRadiation[t] += energy[t];
+		}
+	}
+
+	const double *surfaceRadiation = _downRadiation.data() + beginTile;
+	std::copy(surfaceRadiation, surfaceRadiation + count, backRadiation.begin() + beginTile);
+	std::copy(surfaceRadiation, surfaceRadiation + count, energy);
+	kernels.filterInfrared(surface, energy);
+
+	for (int level = 0; level < levels.levels; level++) {
+		for (int tile = beginTile; tile < endTile; tile++) {
+			int k = level*_tileCount + tile;
+			LayerSlot slot = levels.slots[k];
+			if (slot.index == my::kFakeIndex) continue;
+
+			LayerArrays &layer = layers[slot.type];
+			int i = slot.index;
+
+			layer.temperature[i] = levels.temperature[k];
+			layer.hourlyInfraredInput[i] = levels.infraredInput[k];
+			layer.hourlyInfraredInputDisplay[i] = levels.infraredInputDisplay[k];
+			layer.hourlyOutputRadiation[i] = levels.outputRadiation[k];
+			layer.equilibriumTemperature[i] = levels.equilibriumTemperature[k];
+
+			if (layer.temperature[i] <= 0) { LOG("BELOW ABSOLUTE ZERO"); exit(EXIT_FAILURE); }
+		}
+	}
+}
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
@@ -0,0 +1,75 @@
+#pragma once
+#include "globals.h"
+#include "climate-store.h"
+#include "radiation-kernels.h"
+
+namespace pleistocene {
+namespace simulation {
+namespace climate {
+
+//Flat copies of the layers one sweep works on, level by level: [level*tileCount + tile].
+//Levels a column doesn't reach are padding (kFakeIndex slots, see RadiationBatch)
+struct RadiationLevels {
+	int levels = 0;
+	std::vector<LayerSlot> slots;
+
+	std::vector<double> temperature;
+	std::vector<double> solarInput;
+	std::vector<double> infraredInput;
+	std::vector<double> infraredInputDisplay;
+	std::vector<double> outputRadiation;
+	std::vector<double> equilibriumTemperature;
+	std::vector<double> heatCapacity;
+	std::vector<double> albedo;
+	std::vector<double> solarAbsorptionIndex;
+	std::vector<double> emissionPerT4;
+	std::vector<double> infraredAbsorptionIndex;
+	std::vector<double> emittor;
+
+	void build(int levelCount, int tileCount) noexcept;
+	RadiationBatch batch(int level, int tileCount, int beginTile, int endTile) noexcept;
+};
+
+//Solar and infrared radiation for many columns in lockstep, level by level: the sunlight down-sweep of
+//MaterialColumn::filterSolarRadiation, then the infrared up- and down-sweeps of simulateInfraredRadiation.
+//Each level of every column in a range goes through RadiationKernels at once. Buffers are sized by build,
+//so a sweep allocates nothing, and it runs on the ClimateStore's arrays rather than the layer objects.
+//Sunlight is exact; infrared is as close to the Mixture path as RadiationKernels are.
+class RadiativeTransfer {
+public:
+	//the ClimateStore's layout: column slots bottom to top, and each tile's surface and (contiguous) air slots
+	void build(const std::vector<int> &columnOffsets, const std::vector<LayerSlot> &columnSlots,
+		const std::vector<LayerSlot> &surfaceSlots, const std::vector<int> &airBegin, const std::vector<int> &airEnd) noexcept;
+
+	//incident sunlight on a tile this step (KJ per m2, nothing at night), set before simulate
+	void setSolarEnergy(int tile, double energyKJ) noexcept;
+
+	//tiles [beginTile, endTile), writing each one's back and escape radiation. ranges may run concurrently
+	void simulate(LayerArrays *layers, int beginTile, int endTile,
+		std::vector<double> &backRadiation, std::vector<double> &escapeRadiation) noexcept;
+
+private:
+	int _tileCount = 0;
+
+	std::vector<double> _solarEnergy;
+	std::vector<int> _columnHeights;
+
+	RadiationLevels _solar;//every layer, from the top of the column down
+	RadiationLevels _infrared;//the surface layer, then the air layers upward
+
+	//radiation incident downwards on each air layer, [air layer*tileCount + tile]
+	std::vector<double> _downRadiation;
+	//by tile
+	std::vector<double> _upRadiation;
+	std::vector<double> _emitted;
+	std::vector<double> _energy;
+	std::vector<char> _lit;//sunlight reached this level
+
+	void filterSolar(LayerArrays *layers, int beginTile, int endTile) noexcept;
+	void simulateInfrared(LayerArrays *layers, int beginTile, int endTile,
+		std::vector<double> &backRadiation, std::vector<double> &escapeRadiation) noexcept;
+};
+
+}//namespace climate
+}//namespace simulation
+}//namespace pleistocene
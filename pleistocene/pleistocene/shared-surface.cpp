@@ -1,6 +1,7 @@
 #include "shared-surface.h"
 #include "material-layer.h"
 #include "state-mixture.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -99,6 +100,40 @@ void SharedSurface::flow() noexcept
 }
 
 MaterialLayer* SharedSurface::getTenant() noexcept { return _tenantLayer; }
+MaterialLayer* SharedSurface::getOwner() noexcept { return _ownerLayer; }
+const MaterialLayer* SharedSurface::getTenant() const noexcept { return _tenantLayer; }
+const MaterialLayer* SharedSurface::getOwner() const noexcept { return _ownerLayer; }
+
+void SharedSurface::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_area);
+	writer.write(_midpointElevation);
+	writer.write(_ownerPressure);
+	writer.write(_tenantPressure);
+	writer.write(_pressureDifferential);
+	writer.writeVector(_normalVector);
+	writer.write(_pressureBuilt);
+	writer.write(_netFlux);
+	writer.write(_spatialDirection);
+	writer.write(_tenantType);
+}
+
+void SharedSurface::readSnapshot(my::SnapshotReader &reader, MaterialLayer *ownerLayer, MaterialLayer *tenantLayer) noexcept
+{
+	_ownerLayer = ownerLayer;
+	_tenantLayer = tenantLayer;
+
+	reader.read(_area);
+	reader.read(_midpointElevation);
+	reader.read(_ownerPressure);
+	reader.read(_tenantPressure);
+	reader.read(_pressureDifferential);
+	reader.readVector(_normalVector);
+	reader.read(_pressureBuilt);
+	reader.read(_netFlux);
+	reader.read(_spatialDirection);
+	reader.read(_tenantType);
+}
 
 
 double SharedSurface::getNetFlux() const noexcept { return _netFlux; }
@@ -120,14 +155,28 @@ SharedSurface(surface),
 _ownerAirLayer(ownerLayer),
 _tenantAirLayer(tenantLayer)
 {
+	buildPressureProfiles();
+}
+
+void SharedAirSurface::readSnapshot(my::SnapshotReader &reader, AirLayer *ownerLayer, AirLayer *tenantLayer) noexcept
+{
+	SharedSurface::readSnapshot(reader, ownerLayer, tenantLayer);
+	_ownerAirLayer = ownerLayer;
+	_tenantAirLayer = tenantLayer;
+	buildPressureProfiles();
+}
 
+void SharedAirSurface::buildPressureProfiles() noexcept
+{
+	_ownerProfile = _ownerAirLayer->pressureProfile(_midpointElevation);
+	_tenantProfile = _tenantAirLayer->pressureProfile(_midpointElevation);
 }
 
 void SharedAirSurface::buildPressureDifferential() noexcept
 {
 
-	_ownerPressure = _ownerAirLayer->getPressure(_midpointElevation);
-	_tenantPressure = _tenantAirLayer->getPressure(_midpointElevation);
+	_ownerPressure = _ownerAirLayer->getPressure(_ownerProfile);
+	_tenantPressure = _tenantAirLayer->getPressure(_tenantProfile);
 
 	_pressureDifferential = _ownerPressure - _tenantPressure;
 	_pressureBuilt = true;
@@ -154,30 +203,40 @@ void SharedAirSurface::buildPressureDifferential() noexcept
 //	return molExchange;
 //}
 
-void SharedAirSurface::flow() noexcept 
+double SharedAirSurface::computeFlux(Eigen::Vector3d &ownerInertia, Eigen::Vector3d &tenantInertia, Eigen::Vector3d &kick) noexcept
 {
-	using namespace elements;
-	if (!_pressureBuilt) { LOG("NO PRESSURE BUILT"); exit(EXIT_FAILURE); return; }
+	if (!_pressureBuilt) { LOG("NO PRESSURE BUILT"); exit(EXIT_FAILURE); return 0; }
 
 	double pressureConstant = 3e-14;
 	double flowConstant = 0.2;
 
-	Eigen::Vector3d ownerInertia = _ownerAirLayer->getGasPtr()->getInertia();
-	Eigen::Vector3d tenantInertia = _tenantAirLayer->getGasPtr()->getInertia();
+	kick = _normalVector*_pressureDifferential*pressureConstant;
 
-	ownerInertia += _normalVector*_pressureDifferential*pressureConstant;
-	tenantInertia += _normalVector*_pressureDifferential*pressureConstant;
+	ownerInertia += kick;
+	tenantInertia += kick;
 
 	Eigen::Vector3d average_inertia = (ownerInertia + tenantInertia)*0.5;
 
-	_ownerAirLayer->getGasPtr()->setInertia(ownerInertia);
-	_tenantAirLayer->getGasPtr()->setInertia(tenantInertia);
-
-	Eigen::Vector3d flowVector = flowConstant*average_inertia + _normalVector*_pressureDifferential*pressureConstant;
+	Eigen::Vector3d flowVector = flowConstant*average_inertia + kick;
 
 	_netFlux = _area * (flowVector.dot(this->_normalVector));
-	
-	double flowRate = _netFlux;
+	_pressureBuilt = false;
+
+	return _netFlux;
+}
+
+void SharedAirSurface::flow() noexcept 
+{
+	using namespace elements;
+
+	Eigen::Vector3d ownerInertia = _ownerAirLayer->getGasPtr()->getInertia();
+	Eigen::Vector3d tenantInertia = _tenantAirLayer->getGasPtr()->getInertia();
+	Eigen::Vector3d kick;
+
+	double flowRate = computeFlux(ownerInertia, tenantInertia, kick);
+
+	_ownerAirLayer->getGasPtr()->setInertia(ownerInertia);
+	_tenantAirLayer->getGasPtr()->setInertia(tenantInertia);
 	
 	bool backflow = signbit(flowRate);
 	flowRate = abs(flowRate);
@@ -197,8 +256,6 @@ void SharedAirSurface::flow() noexcept
 	else {
 		GaseousMixture::airFlow(*_tenantAirLayer->getGasPtr(), *_ownerAirLayer->getGasPtr(), flowRate);
 	}
-
-	_pressureBuilt = false;
 }
 
 
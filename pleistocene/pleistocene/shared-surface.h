@@ -2,6 +2,9 @@
 #include <Eigen/Dense>	//linear algebra
 
 namespace pleistocene {
+
+namespace my { class SnapshotWriter; class SnapshotReader; }
+
 namespace simulation {
 namespace climate {
 namespace layers {
@@ -12,7 +15,7 @@ class AirLayer;
 class SeaLayer;
 class EarthLayer;
 class HorizonLayer;
-enum LayerType;
+enum LayerType : int;
 
 enum SpatialDirection {
 	NORTH_EAST,
@@ -34,17 +37,17 @@ protected:
 	double _area;
 	double _midpointElevation;
 	
-	double _ownerPressure;
-	double _tenantPressure;
+	double _ownerPressure = 0;
+	double _tenantPressure = 0;
 
-	double _pressureDifferential;
+	double _pressureDifferential = 0;
 
 	Eigen::Vector3d _normalVector;
 	void buildNormalVector() noexcept;
 
 	bool _pressureBuilt = false;
 
-	double _netFlux;
+	double _netFlux = 0;
 
 public:
 	SharedSurface() noexcept;
@@ -67,6 +70,13 @@ public:
 	void performConduction() noexcept;
 
 	MaterialLayer* getTenant() noexcept;
+	MaterialLayer* getOwner() noexcept;
+	const MaterialLayer* getTenant() const noexcept;
+	const MaterialLayer* getOwner() const noexcept;
+
+	//checkpoint. the MaterialColumn stores which layers the surface joins and passes them back in on restore
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader, MaterialLayer *ownerLayer, MaterialLayer *tenantLayer) noexcept;
 
 	virtual void buildPressureDifferential() noexcept;
 	
@@ -75,19 +85,38 @@ public:
 	double getNetFlux() const noexcept;
 };
 
+//The parts of AirLayer's true pressure at one elevation that depend on geometry only (see AirLayer::pressureProfile)
+struct PressureProfile {
+	double expectedTemperature = 0;
+	double expectedPressure = 0;
+	double lapse = 0;//lapsed temperature above the layer's bottom
+};
+
 class SharedAirSurface : public SharedSurface {
 
 	AirLayer* _ownerAirLayer;
 	AirLayer* _tenantAirLayer;
 
+	//each side's profile at the midpoint elevation, built with the surface
+	PressureProfile _ownerProfile;
+	PressureProfile _tenantProfile;
+
+	void buildPressureProfiles() noexcept;
+
 	//double calculateEquilibriumExchange() const noexcept;
 
 public:
 	SharedAirSurface() noexcept;
 	SharedAirSurface(AirLayer *ownerLayer, AirLayer *tenantLayer, SharedSurface &surface) noexcept;
 
+	void readSnapshot(my::SnapshotReader &reader, AirLayer *ownerLayer, AirLayer *tenantLayer) noexcept;
+
 	void buildPressureDifferential() noexcept;
 
+	//adds this step's pressure kick (also returned in kick) to the layers' inertias passed in and returns the net flux
+	//they drive, as a share of the giving gas: the owner's when positive, the tenant's when negative
+	double computeFlux(Eigen::Vector3d &ownerInertia, Eigen::Vector3d &tenantInertia, Eigen::Vector3d &kick) noexcept;
+
 	void flow() noexcept;
 };
 
@@ -0,0 +1,177 @@
+//pleistocene-sim: headless climate runner
+//generates a world from a seed (or restores a snapshot), runs it for a number of simulated hours without rendering and reports throughput
+
+#include "globals.h"
+#include "game-options.h"
+#include "world.h"
+#include "field-output.h"
+#include "profiler.h"
+#include "radiation-kernels.h"
+#include <chrono>
+
+namespace {
+
+void printUsage() noexcept
+{
+	std::cerr <<
+		"usage: pleistocene-sim [options]\n"
+		"  --seed <n>      world seed (default 32360)\n"
+		"  --hours <n>     simulated hours to run (default 240)\n"
+		"  --size <0-4>    world size option (default 2, 71x60)\n"
+		"  --threads <n>   simulation threads (default: hardware concurrency)\n"
+		"  --serial        run the serial reference sweep\n"
+		"  --no-store      run radiation and conduction on the layer objects instead of the climate store\n"
+		"  --step-hours <n> simulated hours per climate step (default 1). implies --implicit-radiation\n"
+		"  --implicit-radiation  integrate emission implicitly (stable for long steps)\n"
+		"  --implicit-conduction solve conduction up each column implicitly, all columns at once\n"
+		"  --two-phase-air-flow  compute every air flux from the step's starting state, then apply them all (order independent)\n"
+		"  --batched-radiation   run sunlight and infrared on the vectorized radiation kernels (a few ulp from the reference)\n"
+		"  --light-insolation    sunlight from one sun vector per hour instead of a per tile table (a few ulp from the reference)\n"
+		"  --bands <n>     split the rows into n latitude bands, one process each (POSIX), matching the parallel sweep\n"
+		"  --load <file>   start from a world snapshot instead of generating (size comes from the snapshot)\n"
+		"  --save <file>   write a world snapshot after the run\n"
+		"  --fields <list> stream comma separated fields, e.g. temperature:air:0,pressure:air:0,advection-x:air:0,back-radiation\n"
+		"  --field-every <n>      hours between field frames (default 1)\n"
+		"  --field-output <path>  field file prefix (default fields)\n"
+		"  --profile <file>       write per-step timings (see profiler.h) on exit\n";
+}
+
+}//namespace
+
+int main(int argc, char* args[]) noexcept
+{
+	using namespace pleistocene;
+
+	options::GameOptions options;
+	int hours = 240;
+	std::string loadPath;
+	std::string savePath;
+	std::vector<simulation::FieldSpec> fields;
+	int fieldInterval = 1;
+	std::string fieldPrefix = "fields";
+	std::string profilePath;
+	int bands = 0;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = args[i];
+		bool hasValue = (i + 1 < argc);
+
+		if (arg == "--seed" && hasValue) { options._worldSeed = atof(args[++i]); }
+		else if (arg == "--hours" && hasValue) { hours = atoi(args[++i]); }
+		else if (arg == "--size" && hasValue) { options.setWorldSize(atoi(args[++i])); }
+		else if (arg == "--threads" && hasValue) { options._simulationThreads = std::max(1, atoi(args[++i])); }
+		else if (arg == "--serial") { options._parallelSimulation = false; }
+		else if (arg == "--no-store") { options._climateStore = false; }
+		else if (arg == "--step-hours" && hasValue) {
+			options._stepHours = std::max(1, atoi(args[++i]));
+			options._implicitRadiation = true;
+		}
+		else if (arg == "--implicit-radiation") { options._implicitRadiation = true; }
+		else if (arg == "--implicit-conduction") { options._implicitVerticalConduction = true; }
+		else if (arg == "--two-phase-air-flow") { options._twoPhaseAirFlow = true; }
+		else if (arg == "--batched-radiation") { options._batchedRadiation = true; }
+		else if (arg == "--light-insolation") { options._lightInsolation = true; }
+		else if (arg == "--bands" && hasValue) { bands = std::max(1, atoi(args[++i])); }
+		else if (arg == "--load" && hasValue) { loadPath = args[++i]; }
+		else if (arg == "--save" && hasValue) { savePath = args[++i]; }
+		else if (arg == "--fields" && hasValue) {
+			std::stringstream list(args[++i]);
+			std::string text;
+			while (std::getline(list, text, ',')) {
+				simulation::FieldSpec field;
+				if (!simulation::FieldSpec::parse(text, field)) { std::cerr << "unknown field " << text << "\n"; return EXIT_FAILURE; }
+				fields.push_back(field);
+			}
+		}
+		else if (arg == "--field-every" && hasValue) { fieldInterval = std::max(1, atoi(args[++i])); }
+		else if (arg == "--field-output" && hasValue) { fieldPrefix = args[++i]; }
+		else if (arg == "--profile" && hasValue) { profilePath = args[++i]; }
+		else { printUsage(); return EXIT_FAILURE; }
+	}
+
+	hours = (hours + options._stepHours - 1) / options._stepHours * options._stepHours;//whole steps
+
+	if (bands > 0 && !fields.empty()) { std::cerr << "--fields needs the whole world every hour, it can't run with --bands\n"; return EXIT_FAILURE; }
+	if (options._batchedRadiation && !options._climateStore) { std::cerr << "--batched-radiation runs on the climate store, it can't run with --no-store\n"; return EXIT_FAILURE; }
+	//a band is one single-threaded process, and fork must not leave worker threads behind
+	if (bands > 0) options._simulationThreads = 1;
+
+	auto buildStart = std::chrono::steady_clock::now();
+	std::unique_ptr<simulation::World> worldPtr;
+	if (loadPath.empty()) {
+		worldPtr.reset(new simulation::World(options));
+	}
+	else {
+		int rows, cols;
+		if (!simulation::World::readSnapshotDimensions(loadPath, rows, cols)) { return EXIT_FAILURE; }
+		options.setWorldDimensions(rows, cols);
+
+		worldPtr.reset(new simulation::World());
+		if (!worldPtr->loadSnapshot(loadPath)) { return EXIT_FAILURE; }
+	}
+	simulation::World &world = *worldPtr;
+	auto buildEnd = std::chrono::steady_clock::now();
+
+	std::cout << "world " << options.getRows() << "x" << options.getCols();
+	if (loadPath.empty()) { std::cout << ", seed " << options._worldSeed << ", built in "; }
+	else { std::cout << ", " << loadPath << " loaded in "; }
+	std::cout << std::chrono::duration<double>(buildEnd - buildStart).count() << " s\n";
+	for (auto &stage : my::Profiler::lastSamples("world build: ")) {
+		std::cout << "  " << stage.first << " " << stage.second << " s\n";
+	}
+
+	std::unique_ptr<simulation::FieldOutput> fieldOutput;
+	if (!fields.empty()) fieldOutput.reset(new simulation::FieldOutput(fieldPrefix, fields));
+
+	if (bands > options.getRows()) { std::cerr << "--bands can't exceed the " << options.getRows() << " rows\n"; return EXIT_FAILURE; }
+
+	auto runStart = std::chrono::steady_clock::now();
+	if (bands > 0) {
+		if (!world.simulateBands(options, hours, bands)) { return EXIT_FAILURE; }
+	}
+	else {
+		for (int hour = 0; hour < hours; hour += options._stepHours) {
+			my::SimulationTime::updateGlobalTime(options._stepHours);
+			world.simulate(options);
+
+			//a frame whenever the step crosses a multiple of the interval
+			if (fieldOutput && (hour + options._stepHours) / fieldInterval != hour / fieldInterval) fieldOutput->capture(world);
+		}
+	}
+	auto runEnd = std::chrono::steady_clock::now();
+
+	std::string mode;
+	if (bands > 0) { mode = std::to_string(bands) + " bands"; }
+	else if (options._parallelSimulation) { mode = std::to_string(options._simulationThreads) + " threads"; }
+	else { mode = "serial"; }
+
+	if (options._stepHours > 1) { mode += ", " + std::to_string(options._stepHours) + " hour steps"; }
+	if (options._implicitRadiation) { mode += ", implicit radiation"; }
+	if (options._implicitVerticalConduction) { mode += ", implicit conduction"; }
+	if (options._twoPhaseAirFlow) { mode += ", two phase air flow"; }
+	if (options._batchedRadiation) { mode += std::string(", ") + simulation::climate::radiationIsaName(simulation::climate::radiationKernels().isa) + " radiation"; }
+	if (options._lightInsolation) { mode += ", light insolation"; }
+
+	double seconds = std::chrono::duration<double>(runEnd - runStart).count();
+	std::cout << hours << " hours in " << seconds << " s (" << hours / seconds << " hours/s, " << mode << ")\n";
+
+	//quick check of a long-step run against the 1 hour reference
+	double temperatureSum = 0;
+	int layerCount = 0;
+	for (const simulation::Tile &tile : world.getTiles()) {
+		for (const simulation::climate::layers::MaterialLayer *layer : tile._tileClimate.getMaterialColumn().getColumn()) {
+			temperatureSum += layer->getTemperature();
+			layerCount++;
+		}
+	}
+	std::cout << "mean layer temperature " << temperatureSum / layerCount << " K\n";
+
+	if (!savePath.empty()) {
+		if (!world.saveSnapshot(savePath)) { return EXIT_FAILURE; }
+		std::cout << "saved " << savePath << "\n";
+	}
+
+	if (!profilePath.empty() && !my::Profiler::dump(profilePath)) { return EXIT_FAILURE; }
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+#include "simulation-thread.h"
+
+namespace pleistocene {
+namespace simulation {
+
+SimulationThread::SimulationThread(World &world, const options::GameOptions &options) noexcept :
+_world(world),
+_options(options),
+_hourOptions(options),
+_thread(&SimulationThread::loop, this)
+{}
+
+SimulationThread::~SimulationThread() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_one();
+	_thread.join();
+}
+
+void SimulationThread::setOptions(const options::GameOptions &options) noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_options = options;
+}
+
+void SimulationThread::requestHours(int hours) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pendingHours += hours;
+	}
+	_wake.notify_one();
+}
+
+void SimulationThread::setContinuous(bool continuous) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_continuous == continuous) return;
+		_continuous = continuous;
+	}
+	_wake.notify_one();
+}
+
+bool SimulationThread::isIdle() const noexcept
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_running && _pendingHours == 0 && !_continuous;
+}
+
+void SimulationThread::requestPublish(const RenderView &view) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_view = view;
+		_publishRequested = true;
+	}
+	_wake.notify_one();
+}
+
+void SimulationThread::exclusive(const std::function<void()> &task) noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_exclusiveWaiting++;//no new hour starts until we are through
+	}
+	{
+		std::lock_guard<std::mutex> worldLock(_worldMutex);
+		task();
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_exclusiveWaiting--;
+	}
+	_wake.notify_one();
+}
+
+void SimulationThread::loop() noexcept
+{
+	while (true) {
+		bool simulateHour;
+		RenderView view;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [this] {
+				return _quit || (_exclusiveWaiting == 0 && (_pendingHours > 0 || _continuous || _publishRequested));
+			});
+			if (_quit) return;
+
+			simulateHour = (_pendingHours > 0 || _continuous);
+			if (_pendingHours > 0) _pendingHours--;
+			_publishRequested = false;
+
+			_hourOptions = _options;
+			view = _view;
+			_running = true;
+		}
+
+		{
+			std::lock_guard<std::mutex> worldLock(_worldMutex);
+			if (simulateHour) {
+				my::SimulationTime::updateGlobalTime(_hourOptions._stepHours);
+				_world.simulate(_hourOptions);
+			}
+			_world.publishRenderSnapshot(view);
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+}
+
+}//namespace simulation
+}//namespace pleistocene
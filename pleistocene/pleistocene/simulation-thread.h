@@ -0,0 +1,63 @@
+#pragma once
+#include "globals.h"
+#include "game-options.h"
+#include "world.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace pleistocene {
+namespace simulation {
+
+//Runs World::simulate on its own thread so the UI keeps its frame rate however heavy the climate step is.
+//After every hour (and whenever the view changes) it publishes a RenderSnapshot, which is all the UI reads.
+//Anything else that needs the world (new world, quicksave/quickload) goes through exclusive(),
+//which waits for the hour in progress to finish.
+class SimulationThread {
+public:
+	SimulationThread(World &world, const options::GameOptions &options) noexcept;
+	~SimulationThread() noexcept;//finishes the hour in progress
+
+	SimulationThread(const SimulationThread &) = delete;
+	SimulationThread &operator=(const SimulationThread &) = delete;
+
+	//copied, and used from the next hour on
+	void setOptions(const options::GameOptions &options) noexcept;
+
+	void requestHours(int hours) noexcept;
+	//hour after hour until switched off
+	void setContinuous(bool continuous) noexcept;
+	//no hours queued or running
+	bool isIdle() const noexcept;
+
+	//publish for view now if idle, otherwise with the next hour
+	void requestPublish(const RenderView &view) noexcept;
+
+	//runs task on the calling thread while the simulation is stopped between hours
+	void exclusive(const std::function<void()> &task) noexcept;
+
+private:
+	void loop() noexcept;
+
+	World &_world;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _wake;
+	options::GameOptions _options;
+	RenderView _view;
+	int _pendingHours = 0;
+	bool _continuous = false;
+	bool _publishRequested = false;
+	bool _running = false;
+	bool _quit = false;
+	int _exclusiveWaiting = 0;
+
+	std::mutex _worldMutex;//held for each hour and publish, and by exclusive()
+	options::GameOptions _hourOptions;//simulation thread's copy of _options for the hour it runs (GameOptions() would reset the grid)
+
+	std::thread _thread;//last, so it starts once everything above is set up
+};
+
+}//namespace simulation
+}//namespace pleistocene
@@ -1,5 +1,7 @@
 #include "solar-radiation.h"
 #include "tile-climate.h"
+#include "checkpoint.h"
+#include "worker-pool.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -18,50 +20,58 @@ SolarRadiation::SolarRadiation(double latitude_deg, double longitude_deg) noexce
 	_normalVector(2) = sin(_latitude_rad + kTiltRad);
 
 	//longitude shift
-	buildRotationMatrix(_longitude_rad);
+	_normalVector = rotationMatrix(_longitude_rad)*_normalVector;
+
+}
 
-	_normalVector = _rotationMatrix*_normalVector;
 
+void SolarRadiation::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_solarFraction);
+	writer.write(_latitude_rad);
+	writer.write(_longitude_rad);
+	writer.writeVector(_normalVector);
 }
 
+void SolarRadiation::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	reader.read(_solarFraction);
+	reader.read(_latitude_rad);
+	reader.read(_longitude_rad);
+	reader.readVector(_normalVector);
+}
 
-bool SolarRadiation::_axisExists = false;
 
 //Rotation matrix from sidereal angle
-void SolarRadiation::buildRotationMatrix(double angle_rad) noexcept {
-
-	if (!_axisExists) {//First time setup
-		_earthAxis <<	-sin(kTiltRad),
-				0,
-				cos(kTiltRad);
+Eigen::Matrix3d SolarRadiation::rotationMatrix(double angle_rad) noexcept {
 
-		_intermediateMatrix <<	0,		-_earthAxis(2),	_earthAxis(1),
-					_earthAxis(2),	0,		-_earthAxis(0),
-					-_earthAxis(1),	_earthAxis(0),	0;
+	Eigen::Vector3d earthAxis;//earth axis of rotation
+	earthAxis <<	-sin(kTiltRad),
+			0,
+			cos(kTiltRad);
 
-		_axisExists = true;
-	}
-
-	//check if matrix already calculated
-	if (angle_rad == _oldRotation) { return; }
-	_oldRotation = angle_rad;
+	Eigen::Matrix3d K;//cross product matrix of the axis
+	K <<	0,		-earthAxis(2),	earthAxis(1),
+		earthAxis(2),	0,		-earthAxis(0),
+		-earthAxis(1),	earthAxis(0),	0;
 
 	//Rotation Matrix calculation
 	const auto &I3 = Eigen::Matrix3d::Identity();
-	const auto &K = _intermediateMatrix;
 
-	_rotationMatrix = I3 + sin(angle_rad)*K + (1.0 - cos(angle_rad))*(K*K);
-	
+	return I3 + sin(angle_rad)*K + (1.0 - cos(angle_rad))*(K*K);
 }
 
-double SolarRadiation::_oldRotation = my::kFakeDouble;
+const int SolarRadiation::kHoursPerYear = kSolarYear_d*kSolarDay_h;
 
-void SolarRadiation::setupSolarRadiation() noexcept
+//the hourly formulas setupSolarRadiation and applySolarRadiation used before the table, hour by hour through the year
+void SolarRadiation::hourlyGeometry(int hourOfYear, Eigen::Matrix3d &rotationMatrix, Eigen::Vector3d &sunRayVector) noexcept
 {
+	int day = hourOfYear / kSolarDay_h;
+	int hour = hourOfYear % kSolarDay_h;
 
 	//Setup Rotation Matrix
 	//take total hours in this year and divide it by the length of a sidereal day (hours)
-	double sDays = (my::SimulationTime::_globalTime.getHour() + my::SimulationTime::_globalTime.getDay()*kSolarDay_h) / kSiderealDay_h;
+	double sDays = (hour + day*kSolarDay_h) / kSiderealDay_h;
 
 	//take the floor of the number of sidereal days to determine our progress through the current siderial day
 	double sDayFloor = floor(sDays);
@@ -69,42 +79,120 @@ void SolarRadiation::setupSolarRadiation() noexcept
 
 	double angle_rad = sTime*M_PI * 2;//multiply by 2pi to get rad position
 
-	buildRotationMatrix(angle_rad);
+	rotationMatrix = SolarRadiation::rotationMatrix(angle_rad);
 
 	//Setup Sun Ray Vector
 	//sun vector rotates in circle once per solar year
-	angle_rad = 2 * M_PI*(double(my::SimulationTime::_globalTime.getDay() +
-		double(my::SimulationTime::_globalTime.getHour()) / double(kSolarDay_h)) / (double)kSolarYear_d);
+	angle_rad = 2 * M_PI*(double(day + double(hour) / double(kSolarDay_h)) / (double)kSolarYear_d);
 
-	_sunRayVector(0) = cos(angle_rad);
-	_sunRayVector(1) = sin(angle_rad);
-	_sunRayVector(2) = 0;
+	sunRayVector(0) = cos(angle_rad);
+	sunRayVector(1) = sin(angle_rad);
+	sunRayVector(2) = 0;
 }
 
-double SolarRadiation::applySolarRadiation() noexcept {
-	//setupRadiation needs to get called for the hour before these get called.
+void SolarRadiation::buildInsolationTable(const std::vector<SolarRadiation*> &tiles, InsolationMode mode,
+	my::WorkerPool *pool) noexcept
+{
+	_insolationMode = mode;
+	_insolationTiles = int(tiles.size());
+	indexInsolationTable(tiles);
+
+	_insolation.clear();
+	_hourlySunVectors.clear();
+
+	if (mode == EXACT_INSOLATION) { _insolation.resize(size_t(kHoursPerYear)*_insolationTiles); }
+	else { _hourlySunVectors.resize(kHoursPerYear); }
+
+	auto fillRows = [&](int beginHour, int endHour) {
+		Eigen::Matrix3d rotationMatrix;
+		Eigen::Vector3d sunRayVector;
+
+		for (int hourOfYear = beginHour; hourOfYear < endHour; hourOfYear++) {
+			hourlyGeometry(hourOfYear, rotationMatrix, sunRayVector);
+
+			if (mode == LIGHT_INSOLATION) {
+				//sun.(R*n) == (R^T*sun).n
+				_hourlySunVectors[hourOfYear] = rotationMatrix.transpose()*sunRayVector;
+				continue;
+			}
+
+			double *row = _insolation.data() + size_t(hourOfYear)*_insolationTiles;
+			for (int tile = 0; tile < _insolationTiles; tile++) {
+				//rotated normal vector
+				Eigen::Vector3d rotatedNormalVector = rotationMatrix*tiles[tile]->_normalVector;
+
+				double fraction = sunRayVector.dot(rotatedNormalVector);
+
+				if (fraction < 0) {//night
+					fraction = 0;
+				}
+				row[tile] = fraction;
+			}
+		}
+	};
+
+	if (pool) { pool->run(kHoursPerYear, fillRows); }
+	else { fillRows(0, kHoursPerYear); }
+}
 
-	//rotated normal vector
-	Eigen::Vector3d _rotatedNormalVector = _rotationMatrix*_normalVector;
+InsolationMode SolarRadiation::getInsolationMode() noexcept { return _insolationMode; }
 
-	_solarFraction = _sunRayVector.dot(_rotatedNormalVector);
+void SolarRadiation::indexInsolationTable(const std::vector<SolarRadiation*> &tiles) noexcept
+{
+	for (int tile = 0; tile < int(tiles.size()); tile++) {
+		tiles[tile]->_insolationIndex = tile;
+	}
+}
+
+void SolarRadiation::setupSolarRadiation(int stepHours) noexcept
+{
+	_stepHoursOfYear.clear();
+
+	//earlier hours of the step count back from the current one, into the end of the previous year if need be
+	for (int hourOffset = 1 - stepHours; hourOffset <= 0; hourOffset++) {
+		int hour = my::SimulationTime::_globalTime.getHour() + hourOffset;
+		int hourOfYear = (hour + my::SimulationTime::_globalTime.getDay()*kSolarDay_h) % kHoursPerYear;
+		if (hourOfYear < 0) hourOfYear += kHoursPerYear;
+
+		_stepHoursOfYear.push_back(hourOfYear);
+	}
+}
 
-	if (_solarFraction < 0) {//night
-		_solarFraction = 0;
+double SolarRadiation::applySolarRadiation() noexcept {
+	//setupRadiation needs to get called for the hour before these get called.
+	if (_insolationIndex < 0 || _insolationIndex >= _insolationTiles) { LOG("No insolation table for this tile"); exit(EXIT_FAILURE); }
+
+	double fractionSum = 0;
+
+	for (int hourOfYear : _stepHoursOfYear) {
+		double fraction;
+
+		if (_insolationMode == EXACT_INSOLATION) {
+			fraction = _insolation[size_t(hourOfYear)*_insolationTiles + _insolationIndex];
+		}
+		else {
+			fraction = _hourlySunVectors[hourOfYear].dot(_normalVector);
+			if (fraction < 0) {//night
+				fraction = 0;
+			}
+		}
+		fractionSum += fraction;
 	}
 
+	_solarFraction = fractionSum / _stepHoursOfYear.size();
+
 	return _solarFraction;
 }
 
-Eigen::Vector3d SolarRadiation::_sunRayVector;//Vector direction of sun rays
-
-Eigen::Vector3d SolarRadiation::_earthAxis;//earth axis of rotation
-Eigen::Matrix3d SolarRadiation::_intermediateMatrix;//Setup Matrix (constant)
-Eigen::Matrix3d SolarRadiation::_rotationMatrix;//Rotation matrix from sidereal angle
+InsolationMode SolarRadiation::_insolationMode = EXACT_INSOLATION;
+int SolarRadiation::_insolationTiles = 0;
+std::vector<double> SolarRadiation::_insolation;
+std::vector<Eigen::Vector3d> SolarRadiation::_hourlySunVectors;
+std::vector<int> SolarRadiation::_stepHoursOfYear;
 
 
 
-double SolarRadiation::getRadiationShader() noexcept {
+double SolarRadiation::getRadiationShader() const noexcept {
 	double solarShader = _solarFraction*0.8 + 0.2;
 	return solarShader;
 }
@@ -2,46 +2,72 @@
 #include "globals.h"
 
 namespace pleistocene {
+namespace my { class WorkerPool; }
 namespace simulation {
 namespace climate {
 
+//how the insolation table stores a year of sunlight
+enum InsolationMode {
+	EXACT_INSOLATION,	//every tile's fraction for every hour of the year, as the rotation formulas give it (the reference)
+	LIGHT_INSOLATION	//one sun vector per hour in the earth's frame, dotted with each tile's normal. a few ulp from the reference
+};
+
 class SolarRadiation {
 public:
 	SolarRadiation() noexcept;
 	SolarRadiation(double latitude_deg, double longitude_deg) noexcept;
 
-	static void setupSolarRadiation() noexcept;
-
-	//returns a proportion of the max radiation ([0,1]) at the lat,lon at that time 
+	//Sunlight only depends on a tile's latitude and longitude and the hour of the year (kSolarYear_d*kSolarDay_h hours,
+	//which hold a whole number of sidereal days), so a year of it is tabulated up front, hour by hour: each step reads
+	//one contiguous row per hour instead of rotating every tile's normal. tiles index the table in order.
+	//must be rebuilt whenever the tiles are replaced. rows are filled on pool when given
+	static void buildInsolationTable(const std::vector<SolarRadiation*> &tiles, InsolationMode mode,
+		my::WorkerPool *pool = nullptr) noexcept;
+	static InsolationMode getInsolationMode() noexcept;
+	//points tiles at the current table, which covers them if they are the same grid in the same order (a regenerated world).
+	//only writes to the tiles, so it may run alongside a simulation on the table
+	static void indexInsolationTable(const std::vector<SolarRadiation*> &tiles) noexcept;
+
+	//table hours for the stepHours hours up to and including the current global time
+	static void setupSolarRadiation(int stepHours) noexcept;
+
+	//returns a proportion of the max radiation ([0,1]) at the lat,lon, averaged over the step's hours
 	double applySolarRadiation() noexcept;
 
 	double _solarFraction;
-	double getRadiationShader() noexcept;
+	double getRadiationShader() const noexcept;
+
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
 
 private:
 	double _latitude_rad;
 	double _longitude_rad;
 
-
-	//Vector direction of sun rays
-	static Eigen::Vector3d _sunRayVector;
+	int _insolationIndex = my::kFakeIndex;//column of the insolation table
 
 
-	//note, it might make more sense to just determine the hourly rotation matrix and then just keep applying it.
+	//rotation about the earth axis. no shared state, so tiles and table rows can be set up on any thread
+	static Eigen::Matrix3d rotationMatrix(double radiansRotation) noexcept;
+	//earth rotation and sun ray direction at an hour of the year
+	static void hourlyGeometry(int hourOfYear, Eigen::Matrix3d &rotationMatrix, Eigen::Vector3d &sunRayVector) noexcept;
 
-	static void buildRotationMatrix(double radiansRotation) noexcept;
+	static const int kHoursPerYear;
 
-	static double _oldRotation;//check if we can reuse the old rotation matrix
+	static InsolationMode _insolationMode;
+	static int _insolationTiles;
+	//EXACT_INSOLATION: [hour of year*_insolationTiles + tile], night already 0
+	static std::vector<double> _insolation;
+	//LIGHT_INSOLATION: sun ray per hour of year, rotated back into the frame the normal vectors are in
+	static std::vector<Eigen::Vector3d> _hourlySunVectors;
 
-	static bool _axisExists;//Setup flag
-	static Eigen::Vector3d _earthAxis;//earth axis of rotation
-	static Eigen::Matrix3d _intermediateMatrix;//Setup Matrix (constant)
-	static Eigen::Matrix3d _rotationMatrix;//Rotation matrix from sidereal angle
+	//hours of the year in the step, oldest first
+	static std::vector<int> _stepHoursOfYear;
 
 
 	//Normalized vector orthogonal to tile surface
 	//Depends strictly on longitude and latitude
-	//Transformed by _rotationMatrix to determine hourly position before dotted with _sunRayVector
+	//Transformed by the hour's rotation matrix to determine hourly position before dotted with its sun ray vector
 	Eigen::Vector3d _normalVector;
 };
 
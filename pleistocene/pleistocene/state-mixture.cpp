@@ -1,5 +1,6 @@
 #include "state-mixture.h"
 #include "mixture.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 namespace simulation {
@@ -34,25 +35,46 @@ void SolidMixture::calculateParameters() noexcept {
 void SolidMixture::calcualtePorosity() noexcept {
 	using namespace elements;
 	_voidSpace = 0;
-	for (const ElementPair &elementPair : _elements) {
-		_voidSpace += elementPair.second.getVoidSpace();
+	for (const Element &element : _elements) {
+		_voidSpace += element.getVoidSpace();
 	}
 }
 
 void SolidMixture::calculatePermeability() noexcept {
 	using namespace elements;
 	double totalPermeability = 0;
-	for (const ElementPair &elementPair : _elements) {
-		totalPermeability += elementPair.second.getPermeability()*elementPair.second.getVolume();
+	for (const Element &element : _elements) {
+		totalPermeability += element.getPermeability()*element.getVolume();
 	}
 	_permeability = totalPermeability / _totalVolume;
 }
 void SolidMixture::calculateGroundWaterFlow() noexcept {
 }
 
+void SolidMixture::scaleParameters(double proportion) noexcept {
+	Mixture::scaleParameters(proportion);
+	_voidSpace *= std::max(proportion, 0.0);//permeability is a volume average, unchanged by scaling
+}
+
 double SolidMixture::getPermeability() const noexcept { return _permeability; }
 double SolidMixture::getPorosity() const noexcept { return _voidSpace; }
 
+void SolidMixture::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	Mixture::writeSnapshot(writer);
+	writer.write(_saturation);
+	writer.write(_voidSpace);
+	writer.write(_permeability);
+}
+
+void SolidMixture::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	Mixture::readSnapshot(reader);
+	reader.read(_saturation);
+	reader.read(_voidSpace);
+	reader.read(_permeability);
+}
+
 
 //////////////===============================================================
 //////////////PARTICULATE
@@ -94,6 +116,18 @@ DropletMixture::DropletMixture() noexcept {}
 DropletMixture::DropletMixture(Element element, double temperature) noexcept :
 Mixture(element, temperature, elements::DROPLET) {}
 
+void DropletMixture::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	Mixture::writeSnapshot(writer);
+	writer.write(_dropletRadius);
+}
+
+void DropletMixture::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	Mixture::readSnapshot(reader);
+	reader.read(_dropletRadius);
+}
+
 
 
 
@@ -117,6 +151,30 @@ _topElevation(topElevation)
 	//calculateParameters();
 }
 
+void GaseousMixture::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	Mixture::writeSnapshot(writer);
+	_clouds.writeSnapshot(writer);
+	writer.write(_bottomElevation);
+	writer.write(_topElevation);
+	writer.write(_specificHeatCapacity);
+	writer.write(_adiabaticLapseRate);
+	writer.write(_saturationDensity);
+	writer.write(_netFlow);
+}
+
+void GaseousMixture::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	Mixture::readSnapshot(reader);
+	_clouds.readSnapshot(reader);
+	reader.read(_bottomElevation);
+	reader.read(_topElevation);
+	reader.read(_specificHeatCapacity);
+	reader.read(_adiabaticLapseRate);
+	reader.read(_saturationDensity);
+	reader.read(_netFlow);
+}
+
 
 //===================================
 //MIXING GASSES
@@ -124,46 +182,84 @@ _topElevation(topElevation)
 
 void GaseousMixture::airFlow(GaseousMixture &receivingGas, GaseousMixture &givingGas, double proportion) noexcept
 {
+	using namespace elements;
 	//double flow = proportion*givingGas._totalMols;
 
-	GaseousMixture pushMix = givingGas.copyProportion(proportion);
-	givingGas.resizeBy(1 - proportion);
+	//the moved share is the giver scaled by proportion (as resizeBy would scale it), lapsed to the receiver's elevation
+	double movedShare = std::max(proportion, 0.0);
+	double movedMass = givingGas._totalMass*movedShare;
+	double movedMols = givingGas._totalMols*movedShare;
+	double movedHeatCapacity = givingGas._totalHeatCapacity*movedShare;
+	Eigen::Vector3d movedInertia = givingGas._inertia*proportion;
+
+	double deltaElevation = receivingGas._bottomElevation - givingGas._bottomElevation;
+	double movedTemperature = givingGas._temperature - deltaElevation * givingGas._adiabaticLapseRate;
+
+	double totalHeat =	receivingGas._totalHeatCapacity*receivingGas._temperature +
+				movedHeatCapacity*movedTemperature;
+
+	double newTotalHeatCapacity = receivingGas._totalHeatCapacity + movedHeatCapacity;
+
+	receivingGas._temperature = totalHeat / newTotalHeatCapacity;
 
-	receivingGas.push(pushMix);
+	receivingGas._inertia += movedInertia;
+
+	for (Element &element : givingGas._elements) {
+		Element moved = element;
+		moved.resizeBy(proportion);
+		element.resizeBy(1 - proportion);
+		receivingGas.pushSpecific(moved);
+	}
+
+	receivingGas.addParameters(movedMass, 0, movedMols, movedHeatCapacity);//gas volume is fixed
+	receivingGas.calculateLapseRate();
+
+	givingGas._inertia *= (1 - proportion);
+	givingGas.scaleParameters(1 - proportion);
 
 	//givingGas._netFlow -= flow;
 	//receivingGas._netFlow += flow;
 }
 
-GaseousMixture GaseousMixture::copyProportion(double proportion) const noexcept
+FrozenGas GaseousMixture::freeze() const noexcept
 {
-	GaseousMixture copiedMixture = *this;
-	copiedMixture.resizeBy(proportion);
-	return copiedMixture;
+	FrozenGas frozen;
+	frozen.elementMass.fill(0);
+	for (const Element &element : _elements) {
+		frozen.elementMass[element.getElementType()] = element.getMass();
+	}
+	frozen.mass = _totalMass;
+	frozen.mols = _totalMols;
+	frozen.heatCapacity = _totalHeatCapacity;
+	frozen.temperature = _temperature;
+	frozen.bottomElevation = _bottomElevation;
+	frozen.adiabaticLapseRate = _adiabaticLapseRate;
+	frozen.inertia = _inertia;
+	return frozen;
 }
 
-void GaseousMixture::push(GaseousMixture &addedGas) noexcept
+void GaseousMixture::receiveShare(const FrozenGas &giver, double share) noexcept
 {
 	using namespace elements;
 
-	double deltaElevation =  _bottomElevation - addedGas._bottomElevation;
-
-	addedGas.lapseTemperature(deltaElevation);
+	double movedHeatCapacity = giver.heatCapacity*share;
 
-	double totalHeat =	this->_totalHeatCapacity*_temperature +
-				addedGas._totalHeatCapacity*addedGas._temperature;
-
-	double newTotalHeatCapacity = this->_totalHeatCapacity + addedGas._totalHeatCapacity;
+	double deltaElevation = _bottomElevation - giver.bottomElevation;
+	double movedTemperature = giver.temperature - deltaElevation * giver.adiabaticLapseRate;
 
+	double totalHeat = _totalHeatCapacity*_temperature + movedHeatCapacity*movedTemperature;
+	double newTotalHeatCapacity = _totalHeatCapacity + movedHeatCapacity;
 	_temperature = totalHeat / newTotalHeatCapacity;
 
-	_inertia += addedGas._inertia;
+	_inertia += giver.inertia*share;
 
-	for (ElementPair &elementPair : addedGas._elements) {
-		pushSpecific(elementPair.second);
+	for (int type = 0; type < kElementTypes; type++) {
+		if (giver.elementMass[type] <= 0) continue;
+		pushSpecific(Element(MASS, ElementType(type), giver.elementMass[type] * share, GAS));
 	}
 
-	calculateParameters();
+	addParameters(giver.mass*share, 0, giver.mols*share, movedHeatCapacity);//gas volume is fixed
+	calculateLapseRate();
 }
 
 void GaseousMixture::lapseTemperature(double deltaElevation) noexcept
@@ -15,7 +15,7 @@ namespace elements {
 class SolidMixture : public Mixture {
 	//Mixture _suspendedLiquid;//ground water
 
-	double _saturation;//portion of void space occupied
+	double _saturation = 0;//portion of void space occupied
 	double _voidSpace;
 	double _permeability;
 
@@ -25,6 +25,10 @@ public:
 	SolidMixture(std::vector<Element> theElements, double temperature) noexcept;
 
 	void calculateParameters() noexcept;
+	void scaleParameters(double proportion) noexcept;
+
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
 private:
 	void calcualtePorosity() noexcept;
 	void calculatePermeability() noexcept;
@@ -70,11 +74,14 @@ public:
 
 //just clouds. So I'm not going to worry about making this too abstract
 class DropletMixture : public Mixture {
-	double _dropletRadius;
+	double _dropletRadius = 0;
 public:
 	DropletMixture() noexcept;
 	DropletMixture(Element element, double temperature) noexcept;
 
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+
 
 
 };
@@ -83,6 +90,18 @@ public:
 //GAS
 //===============================================================
 
+//TWO_PHASE_AIR_FLOW: a gas as the exchange starts, which its neighbors take their shares of while it updates itself
+struct FrozenGas {
+	std::array<double, kElementTypes> elementMass;//zero where absent
+	double mass;
+	double mols;
+	double heatCapacity;
+	double temperature;
+	double bottomElevation;
+	double adiabaticLapseRate;
+	Eigen::Vector3d inertia;
+};
+
 class GaseousMixture : public Mixture {
 	//ParticulateMixture _suspendedSolid; //snow/ice crystals/aerosals (maybe) (someday)
 	DropletMixture _clouds;//clouds
@@ -103,18 +122,21 @@ public:
 
 	double _netFlow = 0;
 
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+
 	//=======================================
 	//MIXING GAS
 	//=======================================
 
+	//moves proportion of the giver's elements, heat and momentum straight into the receiver, no temporary mixture
 	static void airFlow(GaseousMixture &receivingGas, GaseousMixture &givingGas, double proportion) noexcept;
 
-private:
-	void push(GaseousMixture &addedGas) noexcept;
-	//Mixture pull(Mixture &subtractedMixture) noexcept;
-
-	GaseousMixture copyProportion(double proportion) const noexcept;
+	FrozenGas freeze() const noexcept;
+	//adds share of a frozen giver's elements, heat and momentum, as airFlow would move them here
+	void receiveShare(const FrozenGas &giver, double share) noexcept;
 
+private:
 	void lapseTemperature(double deltaElevation) noexcept;
 
 	void simulateCondensation() noexcept;
@@ -1,5 +1,6 @@
 #include "statistics.h"
 #include "globals.h"
+#include "checkpoint.h"
 
 namespace pleistocene {
 
@@ -148,5 +149,37 @@ std::vector<std::string> Statistics::getMessages() const noexcept {
 	return messages;
 }
 
+void Statistics::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(int32_t(_values.size()));
+	for (double value : _values) writer.write(value);
+	writer.write(_sum);
+	writer.write(_valid);
+
+	writer.write(int32_t(_trackedMeans.size()));
+	for (double mean : _trackedMeans) writer.write(mean);
+	writer.write(int32_t(_trackedSigmas.size()));
+	for (double sigma : _trackedSigmas) writer.write(sigma);
+
+	writer.write(_mean);
+	writer.write(_sigma);
+}
+
+void Statistics::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	_values.resize(reader.read<int32_t>());
+	for (double &value : _values) reader.read(value);
+	reader.read(_sum);
+	reader.read(_valid);
+
+	_trackedMeans.resize(reader.read<int32_t>());
+	for (double &mean : _trackedMeans) reader.read(mean);
+	_trackedSigmas.resize(reader.read<int32_t>());
+	for (double &sigma : _trackedSigmas) reader.read(sigma);
+
+	reader.read(_mean);
+	reader.read(_sigma);
+}
+
 
 }//namespace pleisocene
\ No newline at end of file
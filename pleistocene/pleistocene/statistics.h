@@ -17,7 +17,7 @@ class Statistics{
 	//24 so that we have a full day of data to compare with.
 	//Larger multiples of 24 also may be appropriate.
 	//const int kTrackedFrames=(simulation::climate::kSolarDay_h)*(simulation::climate::kSolarYear_d);
-	const int kTrackedFrames = (simulation::climate::kSolarDay_h);
+	static const int kTrackedFrames = (simulation::climate::kSolarDay_h);
 
 	std::list<double> _trackedMeans;//list of previously computed mean values for this statistic
 	std::list<double> _trackedSigmas;//list of previously computed standards of deviation for this statistic
@@ -47,6 +47,10 @@ public:
 	my::RGB getColor(double value) const noexcept;
 
 	std::vector<std::string> getMessages() const noexcept;
+
+	//tracked history goes into world snapshots so heat map scaling carries over a restore
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
 };
 
 
@@ -1,6 +1,10 @@
 #include "tile-climate.h"
-#include "graphics.h"
 #include "world.h"
+#include "climate-store.h"
+#include "checkpoint.h"
+#ifndef PLEISTOCENE_HEADLESS
+#include "graphics.h"
+#endif
 
 namespace pleistocene {
 namespace simulation {
@@ -11,7 +15,7 @@ namespace climate {
 
 TileClimate::TileClimate() noexcept {}
 
-TileClimate::TileClimate(my::Address A, double noiseValue) noexcept
+void TileClimate::generate(my::Address A, double noiseValue, my::CounterRandom random) noexcept
 {
 	double landElevation = noiseValue * kElevationAmplitude;
 
@@ -24,7 +28,7 @@ TileClimate::TileClimate(my::Address A, double noiseValue) noexcept
 
 	double initialTemperature = calculateLocalInitialtemperature();
 
-	_materialColumn = layers::MaterialColumn(landElevation, initialTemperature);
+	_materialColumn.generate(landElevation, initialTemperature, random);
 }
 
 double TileClimate::calculateLocalInitialtemperature() noexcept
@@ -34,21 +38,51 @@ double TileClimate::calculateLocalInitialtemperature() noexcept
 	return localInitialTemperature;
 }
 
-void TileClimate::buildAdjacency(std::map<my::Direction, TileClimate*> &adjacientTileClimates) noexcept
+void TileClimate::buildAdjacency(const NeighborGraph &graph, const std::vector<layers::MaterialColumn*> &columns) noexcept
 {
-	_adjacientTileClimates = adjacientTileClimates;
+	_materialColumn.buildAdjacency(graph, _address.i, columns);
+}
 
-	std::map<my::Direction, layers::MaterialColumn*> adjacientColumns;
-	my::Direction direction;
-	layers::MaterialColumn* column;
+void TileClimate::linkAdjacency(const NeighborGraph &graph, const std::vector<layers::MaterialColumn*> &columns) noexcept
+{
+	_materialColumn.linkAdjacency(graph, _address.i, columns);
+}
 
-	for (auto &climate : _adjacientTileClimates) {
-		direction = climate.first;
-		column = &(climate.second->_materialColumn);
-		adjacientColumns[direction] = column;
-	}
+void TileClimate::writeSnapshot(my::SnapshotWriter &writer) const noexcept
+{
+	writer.write(_address.r);
+	writer.write(_address.c);
+	writer.write(_longitude_deg);
+	writer.write(_latitude_deg);
+
+	_solarRadiation.writeSnapshot(writer);
+	_materialColumn.writeSnapshot(writer);
+}
+
+void TileClimate::readSnapshot(my::SnapshotReader &reader) noexcept
+{
+	int row = reader.read<int>();
+	int col = reader.read<int>();
+	_address = my::Address(row, col);
+	if (_address.i == my::kFakeIndex) { LOG("Corrupt snapshot (tile address)"); exit(EXIT_FAILURE); }
+
+	reader.read(_longitude_deg);
+	reader.read(_latitude_deg);
+
+	_solarRadiation.readSnapshot(reader);
+	_materialColumn.readSnapshot(reader);
+}
 
-	_materialColumn.buildAdjacency(adjacientColumns);
+void TileClimate::writeState(my::SnapshotWriter &writer) const noexcept
+{
+	_solarRadiation.writeSnapshot(writer);
+	_materialColumn.writeState(writer);
+}
+
+void TileClimate::readState(my::SnapshotReader &reader) noexcept
+{
+	_solarRadiation.readSnapshot(reader);
+	_materialColumn.readState(reader);
 }
 
 
@@ -57,11 +91,46 @@ void TileClimate::buildAdjacency(std::map<my::Direction, TileClimate*> &adjacien
 //======================================
 
 int TileClimate::_simulationStep;
+int TileClimate::_stepHours = 1;
+RadiationScheme TileClimate::_radiationScheme = EXPLICIT_RADIATION;
+
+void TileClimate::setTimeStep(int stepHours, RadiationScheme radiationScheme) noexcept
+{
+	if (stepHours < 1) { LOG("Climate step of " << stepHours << " hours"); exit(EXIT_FAILURE); }
+	_stepHours = stepHours;
+	_radiationScheme = radiationScheme;
+}
+
+int TileClimate::getStepHours() noexcept { return _stepHours; }
+
+RadiationScheme TileClimate::getRadiationScheme() noexcept { return _radiationScheme; }
+
+ConductionScheme TileClimate::_conductionScheme = PAIRWISE_CONDUCTION;
+
+void TileClimate::setConductionScheme(ConductionScheme conductionScheme) noexcept { _conductionScheme = conductionScheme; }
+
+ConductionScheme TileClimate::getConductionScheme() noexcept { return _conductionScheme; }
+
+bool TileClimate::stepSolvesVerticalConduction() noexcept
+{
+	return (_simulationStep == 2 && _conductionScheme == IMPLICIT_VERTICAL_CONDUCTION);
+}
+
+AirFlowScheme TileClimate::_airFlowScheme = SEQUENTIAL_AIR_FLOW;
+
+void TileClimate::setAirFlowScheme(AirFlowScheme airFlowScheme) noexcept { _airFlowScheme = airFlowScheme; }
+
+AirFlowScheme TileClimate::getAirFlowScheme() noexcept { return _airFlowScheme; }
+
+bool TileClimate::stepExchangesAirFlow() noexcept
+{
+	return (_simulationStep == 4 && _airFlowScheme == TWO_PHASE_AIR_FLOW);
+}
 
 void TileClimate::beginNewHour() noexcept
 {
 	_simulationStep = 0;
-	SolarRadiation::setupSolarRadiation();
+	SolarRadiation::setupSolarRadiation(_stepHours);
 	//i.e. create earth rotation matrix for current time and set sun ray vector
 }
 
@@ -71,15 +140,22 @@ bool TileClimate::beginNextStep() noexcept
 	return (_simulationStep <= kTotalSteps);//check if simulation hour complete
 }
 
+//conduction and air flow update neighboring columns through their shared surfaces,
+//so these steps are only run concurrently within a TileColoring class (two phase air flow writes only its own columns)
+bool TileClimate::stepWritesNeighbors() noexcept
+{
+	return (_simulationStep == 2 || (_simulationStep == 4 && _airFlowScheme == SEQUENTIAL_AIR_FLOW));
+}
+
 void TileClimate::simulateClimate() noexcept
 {
-	double solarEnergyPerHour;
+	double solarEnergy;
 
 	switch (_simulationStep) {
 	case(1) :
 		_materialColumn.beginNewHour();
-		solarEnergyPerHour = simulateSolarRadiation();
-		if (solarEnergyPerHour > 0) { _materialColumn.filterSolarRadiation(solarEnergyPerHour); }
+		solarEnergy = simulateSolarRadiation();
+		if (solarEnergy > 0) { _materialColumn.filterSolarRadiation(solarEnergy); }
 		_materialColumn.simulateEvaporation();
 		_materialColumn.simulateInfraredRadiation();
 		break;
@@ -104,29 +180,56 @@ void TileClimate::simulateClimate() noexcept
 	}
 }
 
+void TileClimate::simulateClimate(ClimateStore &store, int tile) noexcept
+{
+	double solarEnergy;
+
+	switch (_simulationStep) {
+	case(1) :
+		store.beginNewHour(tile);
+		solarEnergy = simulateSolarRadiation();
+		if (store.batchesRadiationAfter(_simulationStep)) {
+			//the engine filters sunlight and infrared after every tile has set its sunlight (evaporation is a stub, so order doesn't matter yet)
+			store.setSolarEnergy(tile, solarEnergy);
+			_materialColumn.simulateEvaporation();
+			break;
+		}
+		if (solarEnergy > 0) { store.filterSolarRadiation(tile, solarEnergy); }
+		_materialColumn.simulateEvaporation();
+		store.simulateInfraredRadiation(tile);
+		break;
+	case(2) :
+		store.simulateConduction(tile);
+		break;
+	default:
+		simulateClimate();
+	}
+}
+
+layers::MaterialColumn &TileClimate::getMaterialColumn() noexcept { return _materialColumn; }
+const layers::MaterialColumn &TileClimate::getMaterialColumn() const noexcept { return _materialColumn; }
+SolarRadiation &TileClimate::getSolarRadiation() noexcept { return _solarRadiation; }
+
 double TileClimate::simulateSolarRadiation() noexcept
 {
-	double solarFraction = _solarRadiation.applySolarRadiation();
-	double incidentSolarEnergyPerHour = solarFraction*kSolarEnergyPerHour;
-	return incidentSolarEnergyPerHour;
+	double solarFraction = _solarRadiation.applySolarRadiation();//mean over the step's hours
+	double incidentSolarEnergy = solarFraction*kSolarEnergyPerHour*_stepHours;
+	return incidentSolarEnergy;
 }
 
+#ifndef PLEISTOCENE_HEADLESS
 //======================================
 //GRAPHICS
 //======================================
 
-bool TileClimate::elevationDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, bool sunlit) noexcept
+bool TileClimate::elevationDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, double elevation, double solarShader, bool sunlit) noexcept
 {
-
-	double elevation = _materialColumn.getLandElevation();
-
 	double elevationShader;
 	elevationType elevationDrawType;
 
 	setElevationDrawSpecs(elevation, elevationShader, elevationDrawType);
 
-	double solarShader = 1;
-	if (sunlit) solarShader = _solarRadiation.getRadiationShader(); //TODO control of shading....
+	if (!sunlit) solarShader = 1; //TODO control of shading....
 
 	double textureShader = solarShader*elevationShader;
 	textureShader = std::max(textureShader, 0.05);
@@ -159,9 +262,9 @@ void TileClimate::setElevationDrawSpecs(double elevation, double &computedElevat
 	return;
 }
 
-void TileClimate::advectionDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, const StatRequest &statRequest) noexcept
+void TileClimate::advectionDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, my::Vector2d advection) noexcept
 {
-	Eigen::Vector2d advectionVector = _materialColumn.getAdvection(statRequest);
+	Eigen::Vector2d advectionVector(advection.x, advection.y);
 
 	double norm = advectionVector.norm()*1e11;
 
@@ -175,7 +278,7 @@ void TileClimate::advectionDraw(graphics::Graphics &graphics, std::vector<SDL_Re
 	} 
 	else if (norm>=5) {//steady wind
 		barbSelected = size_t(norm / 5)+1;
-		barbSelected = std::min(barbSelected, 17u);
+		barbSelected = std::min(barbSelected, size_t(17));
 		null_barb = false;
 	}
 
@@ -244,6 +347,8 @@ void TileClimate::setupTextures(graphics::Graphics &graphics)  noexcept
 	}
 }
 
+#endif
+
 //===========================================
 //GETTERS
 //===========================================
@@ -253,6 +358,8 @@ double TileClimate::getStatistic(const StatRequest &statRequest) const noexcept
 	return _materialColumn.getStatistic(statRequest);
 }
 
+double TileClimate::getSolarShader() const noexcept { return _solarRadiation.getRadiationShader(); }
+
 std::vector<std::string> TileClimate::getMessages(const StatRequest &statRequest) const noexcept 
 {
 	using namespace climate;
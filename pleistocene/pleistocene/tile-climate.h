@@ -18,6 +18,8 @@ struct StatRequest;
 
 namespace climate {
 
+class ClimateStore;
+
 //CONSTANTS
 //i mean... kConstants
 //=============================
@@ -33,6 +35,25 @@ const int kHour_s = 3600;
 //for instance, tiles baking in the sun only get to release radiation afterwards (although this might get changed)
 //this leads to super hot tiles which (due to the T^4 scaling of radiation) then overestimates the emitted radiaion
 //const int hour_s = 14400;
+//(multi-hour steps are instead taken with TileClimate::setTimeStep and IMPLICIT_RADIATION)
+
+//how a layer's emission is integrated over a climate step
+enum RadiationScheme {
+	EXPLICIT_RADIATION,	//emission at the temperature the step starts from, capped at equilibrium when warming (the 1 hour reference)
+	IMPLICIT_RADIATION	//backward Euler, Newton solved (Mixture::radiateImplicit). stable for steps of many hours
+};
+
+//how conduction between the layers of a column is integrated over a climate step
+enum ConductionScheme {
+	PAIRWISE_CONDUCTION,	//every shared surface exchanges in turn, capped at equalization (the reference)
+	IMPLICIT_VERTICAL_CONDUCTION	//each column is one backward Euler tridiagonal system (MaterialColumn::simulateVerticalConduction), side surfaces stay pairwise
+};
+
+//how air moves through the shared air surfaces over a climate step
+enum AirFlowScheme {
+	SEQUENTIAL_AIR_FLOW,	//every surface transfers in turn and sees what the ones before it moved (the reference, colored sweep)
+	TWO_PHASE_AIR_FLOW	//every flux from the state the step starts from, then each layer gathers its own (AirFlowExchange). order independent
+};
 
 const double kSiderealDay_h = double(kSolarDay_h*kSolarYear_d) / double(kSolarYear_d + 1);//hours it takes earth to rotate through 2 pi radians
 const double kTiltRad = 0.4101524;//radians of axial tilt
@@ -79,8 +100,6 @@ class TileClimate {
 	SolarRadiation _solarRadiation;//local incident radiation
 	layers::MaterialColumn _materialColumn;
 
-	std::map<my::Direction, TileClimate*> _adjacientTileClimates;
-
 public:
 	//INIITIALIZATION
 	//==============================================
@@ -88,20 +107,34 @@ public:
 	TileClimate() noexcept;
 
 
-	TileClimate(my::Address A, double noiseValue) noexcept;
+	//builds the column in place, replacing any there was. neighbors are linked afterwards by buildAdjacency.
+	//random is this tile's stream of the world seed's, see my::CounterRandom
+	void generate(my::Address A, double noiseValue, my::CounterRandom random) noexcept;
+
+	//columns: every tile's column, by tile (see MaterialColumn::buildAdjacency)
+	void buildAdjacency(const NeighborGraph &graph, const std::vector<layers::MaterialColumn*> &columns) noexcept;
+	//adjacency without building surfaces (restoring a snapshot)
+	void linkAdjacency(const NeighborGraph &graph, const std::vector<layers::MaterialColumn*> &columns) noexcept;
 
-	void buildAdjacency(std::map<my::Direction, TileClimate*> &adjacientTileClimates) noexcept;
+	//checkpoint. surfaces go through getMaterialColumn() once every tile is read and linked
+	void writeSnapshot(my::SnapshotWriter &writer) const noexcept;
+	void readSnapshot(my::SnapshotReader &reader) noexcept;
+	//simulation state only, read in place (see MaterialColumn::readState)
+	void writeState(my::SnapshotWriter &writer) const noexcept;
+	void readState(my::SnapshotReader &reader) noexcept;
 
 
+#ifndef PLEISTOCENE_HEADLESS
 	//=================================================
 	//GRAPHICS
 	//=================================================
 	static void setupTextures(graphics::Graphics &graphics) noexcept;
 
 
-	bool elevationDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, bool sunlit) noexcept;
+	//drawn from published render values (see RenderSnapshot), not the live column
+	static bool elevationDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, double elevation, double solarShader, bool sunlit) noexcept;
 
-	void advectionDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, const StatRequest &statRequest) noexcept;
+	static void advectionDraw(graphics::Graphics &graphics, std::vector<SDL_Rect> onscreenPositions, my::Vector2d advection) noexcept;
 
 private:
 
@@ -110,7 +143,8 @@ private:
 	static std::vector<SDL_Rect> _windBarbRects;
 
 	//Standard Draw Subroutine
-	void setElevationDrawSpecs(double elevation, double &computedElevationShader, elevationType &computedElevationType) noexcept;
+	static void setElevationDrawSpecs(double elevation, double &computedElevationShader, elevationType &computedElevationType) noexcept;
+#endif
 
 public:
 	//=================================================
@@ -120,12 +154,40 @@ public:
 
 	static int _simulationStep;
 	static bool beginNextStep() noexcept;
+	static bool stepWritesNeighbors() noexcept;
+
+	//simulated hours per climate hour (sunlight, emission and conduction are integrated over all of them)
+	static void setTimeStep(int stepHours, RadiationScheme radiationScheme) noexcept;
+	static int getStepHours() noexcept;
+	static RadiationScheme getRadiationScheme() noexcept;
+
+	static void setConductionScheme(ConductionScheme conductionScheme) noexcept;
+	static ConductionScheme getConductionScheme() noexcept;
+	//IMPLICIT_VERTICAL_CONDUCTION: the column solves run (for every tile) before this step's kernels, which then only conduct sideways
+	static bool stepSolvesVerticalConduction() noexcept;
+
+	static void setAirFlowScheme(AirFlowScheme airFlowScheme) noexcept;
+	static AirFlowScheme getAirFlowScheme() noexcept;
+	//TWO_PHASE_AIR_FLOW: the exchange runs (for every tile) before this step's kernels, which then only apply the column's boundary conditions
+	static bool stepExchangesAirFlow() noexcept;
 
 	void simulateClimate() noexcept;
+	//steps the ClimateStore handles run on its arrays (tile is this climate's store index)
+	void simulateClimate(ClimateStore &store, int tile) noexcept;
+
+	layers::MaterialColumn &getMaterialColumn() noexcept;
+	const layers::MaterialColumn &getMaterialColumn() const noexcept;
+	SolarRadiation &getSolarRadiation() noexcept;
+
+	//incident solar energy this step (KJ per m2), also used by pleistocene-bench to drive the column directly
+	double simulateSolarRadiation() noexcept;
 private:
 	static const int kTotalSteps = 5;
 
-	double simulateSolarRadiation() noexcept;
+	static int _stepHours;
+	static RadiationScheme _radiationScheme;
+	static ConductionScheme _conductionScheme;
+	static AirFlowScheme _airFlowScheme;
 
 
 	
@@ -137,6 +199,9 @@ public:
 	//===========================================
 	double getStatistic(const StatRequest &statRequest) const noexcept;
 
+	//day/night shading of the tile this hour
+	double getSolarShader() const noexcept;
+
 	std::vector<std::string> getMessages(const StatRequest &statRequest) const noexcept;
 };
 
@@ -0,0 +1,70 @@
+#include "tile-coloring.h"
+#include "material-layer.h"
+
+namespace pleistocene {
+namespace simulation {
+
+TileColoring::TileColoring() noexcept {}
+
+void TileColoring::build(const NeighborGraph &graph) noexcept
+{
+	int tileCount = graph.getTileCount();
+
+	std::vector<std::vector<int>> writeSets(tileCount);
+	std::vector<std::vector<int>> writers(tileCount);//writers[j]: tiles whose write set contains j
+
+	for (int i = 0; i < tileCount; i++) {
+		writeSets[i] = writeSet(graph, i);
+		for (int j : writeSets[i]) {
+			writers[j].push_back(i);
+		}
+	}
+
+	std::vector<int> colors(tileCount, -1);
+	std::vector<bool> colorTaken;
+	int colorCount = 0;
+
+	for (int i = 0; i < tileCount; i++) {
+		colorTaken.assign(colorCount + 1, false);
+
+		//any tile writing something this tile writes conflicts with it
+		for (int j : writeSets[i]) {
+			for (int k : writers[j]) {
+				if (colors[k] >= 0) colorTaken[colors[k]] = true;
+			}
+		}
+
+		int color = 0;
+		while (colorTaken[color]) color++;
+
+		colors[i] = color;
+		colorCount = std::max(colorCount, color + 1);
+	}
+
+	_colorClasses.assign(colorCount, std::vector<int>());
+	for (int i = 0; i < tileCount; i++) {
+		_colorClasses[colors[i]].push_back(i);
+	}
+}
+
+int TileColoring::getColorCount() const noexcept { return int(_colorClasses.size()); }
+
+const std::vector<int> &TileColoring::getColorClass(int color) const noexcept { return _colorClasses[color]; }
+
+std::vector<int> TileColoring::writeSet(const NeighborGraph &graph, int tile) noexcept
+{
+	std::vector<int> tiles{ tile };
+
+	for (my::Direction direction : climate::layers::ownedDirections) {
+		int32_t neighbor = graph.getNeighbor(tile, direction);
+		if (neighbor == NeighborGraph::kNoNeighbor) continue;
+		if (std::find(tiles.begin(), tiles.end(), neighbor) == tiles.end()) {
+			tiles.push_back(neighbor);
+		}
+	}
+
+	return tiles;
+}
+
+}//namespace simulation
+}//namespace pleistocene
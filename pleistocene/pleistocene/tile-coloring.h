@@ -0,0 +1,31 @@
+#pragma once
+#include "globals.h"
+#include "neighbor-graph.h"
+
+namespace pleistocene {
+namespace simulation {
+
+//Partition of the hex grid into independent sets for kernels that write neighboring tiles.
+//A tile's kernel may write the tile itself and the tenants of its shared surfaces, which by the
+//ownedDirections convention lie NE, E and SE of it. Two tiles share a color only if these write
+//sets are disjoint, so a whole color class can be simulated concurrently without locks, and the
+//result is independent of how the class is split across threads.
+class TileColoring {
+public:
+	TileColoring() noexcept;
+
+	//greedy coloring in tile index order over the grid's neighbors
+	void build(const NeighborGraph &graph) noexcept;
+
+	int getColorCount() const noexcept;
+	const std::vector<int> &getColorClass(int color) const noexcept;
+
+	//tiles the kernel at tile may write (itself first)
+	static std::vector<int> writeSet(const NeighborGraph &graph, int tile) noexcept;
+
+private:
+	std::vector<std::vector<int>> _colorClasses;
+};
+
+}//namespace simulation
+}//namespace pleistocene
@@ -1,8 +1,10 @@
 #include "tile.h"
-#include "graphics.h"
 #include "world.h"
-#include "bios.h"
 #include "statistics.h"
+#ifndef PLEISTOCENE_HEADLESS
+#include "graphics.h"
+#include "bios.h"
+#endif
 
 namespace pleistocene {
 namespace simulation {
@@ -13,10 +15,12 @@ Tile::Tile(my::Address tileAddress) noexcept {
 
 	_address = tileAddress;
 
+#ifndef PLEISTOCENE_HEADLESS
 	_gameRectangle.x = _address.getGamePos().x;
 	_gameRectangle.y = _address.getGamePos().y;
 	_gameRectangle.w = globals::kTileWidth;
 	_gameRectangle.h = globals::kTileHeight;
+#endif
 
 	my::Vector2d latLonDeg = _address.getLatLonDeg();
 
@@ -25,16 +29,6 @@ Tile::Tile(my::Address tileAddress) noexcept {
 }
 
 
-void Tile::buildNeighborhood() noexcept {
-	my::Address neighborAddress;
-	for (int j = 0; j < 6; j++) {
-		neighborAddress = this->_address.adjacent(j);
-		if (neighborAddress.i != my::kFakeIndex) {
-			this->_directionalNeighbors[static_cast<my::Direction>(j)] = neighborAddress;
-		}
-	}
-}
-
 //SIMULATION
 //============================
 
@@ -44,25 +38,26 @@ void Tile::simulate() noexcept {
 }
 
 
+#ifndef PLEISTOCENE_HEADLESS
 //GRAPHICS
 //=======================
 
 
-bool Tile::statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const Statistics &statistics, const StatRequest &statRequest) noexcept
+bool Tile::statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const Statistics &statistics, const StatRequest &statRequest, const TileRenderValues &values) noexcept
 {
 	//onscreen guard against wasting time. Also updates onscreen position.
 	if (!onscreenPositionUpdate(graphics, cameraMovementFlag)) {
 		return false;
 	}
 	
-	if (_statValue == my::kFakeDouble) {//no legitimate value
+	if (values._statValue == my::kFakeDouble) {//no legitimate value
 		graphics.colorFilter(_colorTextures[0], 0, 0, 0);//filter to black
 		return graphics.blitTexture(_colorTextures[0], NULL, _onscreenPositions);
 	}
 	
 
 	//determine draw color
-	my::RGB rgb = statistics.getColor(this->_statValue);
+	my::RGB rgb = statistics.getColor(values._statValue);
 	graphics.colorFilter(_colorTextures[0], rgb.r, rgb.g, rgb.b);
 
 
@@ -81,7 +76,7 @@ bool Tile::statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const
 
 
 	if (statRequest._statType == FLOW) {
-		_tileClimate.advectionDraw(graphics, _onscreenPositions, statRequest);
+		climate::TileClimate::advectionDraw(graphics, _onscreenPositions, values._advection);
 	}
 
 
@@ -89,12 +84,12 @@ bool Tile::statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const
 }
 
 
-bool Tile::elevationDraw(graphics::Graphics &graphics, bool cameraMovementFlag, bool sunlit) noexcept 
+bool Tile::elevationDraw(graphics::Graphics &graphics, bool cameraMovementFlag, bool sunlit, const TileRenderValues &values) noexcept 
 {
 	if (!onscreenPositionUpdate(graphics, cameraMovementFlag)) { //checks 
 		return false;
 	}
-	return _tileClimate.elevationDraw(graphics, _onscreenPositions, sunlit);
+	return climate::TileClimate::elevationDraw(graphics, _onscreenPositions, values._elevation, values._solarShader, sunlit);
 }
 
 
@@ -116,10 +111,14 @@ void Tile::setupTextures(graphics::Graphics &graphics) noexcept
 	graphics.loadImage(_colorTextures[0]);
 }
 
+#endif
+
 //GETTERS
 //=================
 
+#ifndef PLEISTOCENE_HEADLESS
 SDL_Rect Tile::getGameRect() const noexcept { return _gameRectangle; }
+#endif
 
 std::vector<std::string> Tile::sendMessages(const StatRequest &statRequest) const noexcept {
 
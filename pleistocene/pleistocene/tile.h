@@ -12,6 +12,7 @@ namespace simulation {
 
 
 struct StatRequest;
+struct TileRenderValues;
 
 //Tiles are hexagons
 //organized into horizontal rows and vertical columns in my::Vector2 _tileAddress(row,column)
@@ -23,18 +24,12 @@ public:
 	Tile() noexcept;
 	Tile(my::Address tileAddress) noexcept;
 
-	
-	void buildNeighborhood() noexcept;
-	//Map to adjacient tile addresses
-	std::map<my::Direction, my::Address> _directionalNeighbors;
-
-
-
 
+#ifndef PLEISTOCENE_HEADLESS
 	//GRAPHICS
 	//====================
-	bool statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const Statistics &statistics, const StatRequest &statRequest) noexcept;
-	bool elevationDraw(graphics::Graphics &graphics, bool cameraMovementFlag, bool sunlit) noexcept;
+	bool statDraw(graphics::Graphics &graphics, bool cameraMovementFlag, const Statistics &statistics, const StatRequest &statRequest, const TileRenderValues &values) noexcept;
+	bool elevationDraw(graphics::Graphics &graphics, bool cameraMovementFlag, bool sunlit, const TileRenderValues &values) noexcept;
 
 	static std::map<int, std::string> _colorTextures;
 	static void setupTextures(graphics::Graphics &graphics) noexcept;
@@ -43,6 +38,7 @@ private:
 	std::vector<SDL_Rect> _onscreenPositions;
 	//my::Rectangle with ingame tile dimensions
 	SDL_Rect _gameRectangle;
+#endif
 
 
 public:
@@ -52,7 +48,9 @@ public:
 	//(row,column)
 	my::Address _address;
 
+#ifndef PLEISTOCENE_HEADLESS
 	SDL_Rect getGameRect() const noexcept;
+#endif
 	std::vector<std::string> sendMessages(const StatRequest &statRequest) const noexcept;//communicates with bios
 
 
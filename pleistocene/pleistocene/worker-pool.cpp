@@ -0,0 +1,96 @@
+#include "worker-pool.h"
+
+namespace pleistocene {
+namespace my {
+
+WorkerPool::WorkerPool(int threadCount) noexcept :
+_nextIndex(0)
+{
+	threadCount = std::max(threadCount, 1);
+
+	//the thread calling run() is the first worker
+	for (int i = 1; i < threadCount; i++) {
+		_threads.emplace_back(&WorkerPool::workerLoop, this);
+	}
+}
+
+WorkerPool::~WorkerPool() noexcept
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_workReady.notify_all();
+
+	for (std::thread &thread : _threads) {
+		thread.join();
+	}
+}
+
+int WorkerPool::getThreadCount() const noexcept { return int(_threads.size()) + 1; }
+
+void WorkerPool::run(int count, const std::function<void(int, int)> &task) noexcept
+{
+	if (count <= 0) return;
+
+	//nothing to share
+	if (_threads.empty()) {
+		task(0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(_runMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_count = count;
+		//several chunks per thread so uneven tiles (land vs sea columns) balance out
+		_chunkSize = std::max(1, count / (getThreadCount() * 8));
+		_nextIndex = 0;
+		_busyWorkers = int(_threads.size());
+		_generation++;
+	}
+	_workReady.notify_all();
+
+	processChunks();
+
+	//barrier
+	std::unique_lock<std::mutex> lock(_mutex);
+	_workDone.wait(lock, [this] { return _busyWorkers == 0; });
+	_task = nullptr;
+}
+
+void WorkerPool::workerLoop() noexcept
+{
+	int seenGeneration = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_workReady.wait(lock, [this, seenGeneration] { return _quit || _generation != seenGeneration; });
+			if (_quit) return;
+			seenGeneration = _generation;
+		}
+
+		processChunks();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_busyWorkers--;
+		}
+		_workDone.notify_one();
+	}
+}
+
+void WorkerPool::processChunks() noexcept
+{
+	int begin;
+	while ((begin = _nextIndex.fetch_add(_chunkSize)) < _count) {
+		int end = std::min(begin + _chunkSize, _count);
+		(*_task)(begin, end);
+	}
+}
+
+}//namespace my
+}//namespace pleistocene
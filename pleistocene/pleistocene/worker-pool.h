@@ -0,0 +1,51 @@
+#pragma once
+#include "globals.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+namespace pleistocene {
+namespace my {
+
+//Fixed set of worker threads for splitting an index range (e.g. the tile sweep) across cores.
+//The calling thread works alongside the pool, and run() only returns once every index has been processed,
+//so consecutive calls to run() are separated by a barrier.
+class WorkerPool {
+public:
+	WorkerPool(int threadCount) noexcept;
+	~WorkerPool() noexcept;
+
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool &operator=(const WorkerPool &) = delete;
+
+	int getThreadCount() const noexcept;
+
+	//calls task(begin, end) on contiguous chunks covering [0, count).
+	//chunks are handed out dynamically, so task must not depend on which thread runs which chunk.
+	void run(int count, const std::function<void(int, int)> &task) noexcept;
+
+private:
+	void workerLoop() noexcept;
+	void processChunks() noexcept;
+
+	std::vector<std::thread> _threads;
+
+	std::mutex _runMutex;//one run() at a time
+	std::mutex _mutex;
+	std::condition_variable _workReady;
+	std::condition_variable _workDone;
+
+	const std::function<void(int, int)> *_task = nullptr;
+	int _count = 0;
+	int _chunkSize = 1;
+	std::atomic<int> _nextIndex;
+
+	int _generation = 0;//incremented for each run() so sleeping workers know there is new work
+	int _busyWorkers = 0;
+	bool _quit = false;
+};
+
+}//namespace my
+}//namespace pleistocene
@@ -1,42 +1,77 @@
 #include "world.h"
 #include "game-options.h"
+#include "noise.h"
+#include "checkpoint.h"
+#include "profiler.h"
+#include "simulation-thread.h"
+#include "band-decomposition.h"
+#ifndef PLEISTOCENE_HEADLESS
 #include "bios.h"
 #include "graphics.h"
-#include "noise.h"
 #include "input.h"
+#endif
 
 namespace pleistocene {
 namespace simulation {
 
 World::World() noexcept {}
 
-World::World(graphics::Graphics &graphics, const options::GameOptions &options) noexcept :
+World::World(const options::GameOptions &options) noexcept :
 _statRequest(StatRequest()),
 _selectedTile(nullptr),
-_seed(32360),
+_seed(options._worldSeed),
 _statisticsUpToDate(false)
 {
-	srand((unsigned int)time(NULL));//seed random number generation
+	//first: every world build stage runs on it
+	_workerPool.reset(new my::WorkerPool(options._simulationThreads));
 
 	//build tiles in memory and calls setup functions
-	setupTiles(graphics);
+	_neighborGraph.build();
+	setupTiles(liveBuild());
+	_tileColoring.build(_neighborGraph);
 	
 	//World generating algorithm
 	generateWorld(options);
 }
 
-void World::setupTiles(graphics::Graphics &graphics) noexcept {
-	buildTileVector();
+#ifndef PLEISTOCENE_HEADLESS
+World::World(graphics::Graphics &graphics, const options::GameOptions &options) noexcept :
+World(options)
+{
 	setupTextures(graphics);
-	buildTileNeighbors();
+}
+#endif
+
+World::~World() noexcept
+{
+	if (_regenerationThread.joinable()) _regenerationThread.join();
+}
+
+World::BuildTarget World::liveBuild() noexcept
+{
+	BuildTarget build;
+	build.tiles = &_tiles;
+	build.columns = &_columns;
+	build.climateStore = &_climateStore;
+	build.airFlowExchange = &_airFlowExchange;
+	build.seed = _seed;
+	build.pool = _workerPool.get();
+	return build;
+}
+
+void World::setupTiles(const BuildTarget &build) noexcept {
+	my::ScopedTimer timer("world build: tiles");
+	buildTileVector(*build.tiles);
+	buildColumnTable(build);
 }
 
 //initializes each tile at a default depth
-void World::buildTileVector() noexcept {
+void World::buildTileVector(std::vector<Tile> &tiles) noexcept {
 	//Tile constructor
+	tiles.reserve(size_t(my::Address::GetRows())*my::Address::GetCols());
 	for (int row = 0; row < my::Address::GetRows(); row++) {
 		for (int col = 0; col < my::Address::GetCols(); col++) {
-			_tiles.emplace_back(my::Address(row, col));
+			tiles.emplace_back(my::Address(row, col));
 			if (my::Address(row, col).i == my::kFakeIndex) { LOG("not a valid Address");  exit(EXIT_FAILURE); }
 		}
 	}
@@ -44,27 +79,141 @@ void World::buildTileVector() noexcept {
 
 void World::generateWorld(const options::GameOptions &options) noexcept 
 {
-	generateTileElevations();
-	setupTileClimateAdjacency();
+	BuildTarget build = liveBuild();
+	generateTileElevations(build);
+	finishWorldBuild(build);
+
+	my::ScopedTimer timer("world build: insolation");
+	buildInsolationTable(climate::SolarRadiation::getInsolationMode());
 }
 
-void World::buildTileNeighbors() noexcept {
-	for (Tile &T : _tiles) {
-		T.buildNeighborhood();
+void World::generateSyntheticWorld(double landFraction) noexcept
+{
+	const double landNoise = 500 / climate::kElevationAmplitude;
+	const double seaNoise = -2000 / climate::kElevationAmplitude;
+
+	BuildTarget build = liveBuild();
+	{
+		my::ScopedTimer timer("world build: columns");
+		forEachBuildRange(build.pool, int(_tiles.size()), [&](int begin, int end) {
+			for (int i = begin; i < end; i++) {
+				my::Address A = _tiles[i]._address;
+
+				my::CounterRandom random = my::CounterRandom(uint64_t(_seed)).stream(A.i);
+				double draw = random.uniform();
+
+				_tiles[i]._tileClimate.generate(A, draw < landFraction ? landNoise : seaNoise, random);
+			}
+		});
 	}
+
+	finishWorldBuild(build);
+
+	my::ScopedTimer timer("world build: insolation");
+	buildInsolationTable(climate::SolarRadiation::getInsolationMode());
 }
 
+void World::finishWorldBuild(const BuildTarget &build) noexcept
+{
+	{
+		my::ScopedTimer timer("world build: surfaces");
+		setupTileClimateAdjacency(build);
+	}
+	{
+		my::ScopedTimer timer("world build: climate store");
+		buildClimateStore(build);
+	}
+	{
+		my::ScopedTimer timer("world build: air flow");
+		buildAirFlowExchange(build);
+	}
+}
+
+void World::forEachBuildRange(my::WorkerPool *pool, int count, const std::function<void(int, int)> &task) noexcept
+{
+	if (pool) { pool->run(count, task); }
+	else { task(0, count); }
+}
+
+bool World::startRegeneration(const options::GameOptions &options, double seed) noexcept
+{
+	if (_regenerationThread.joinable()) return false;
+
+	_regenerationReady = false;
+	_spareSeed = seed;
+	int threadCount = options._simulationThreads;
+
+	_regenerationThread = std::thread([this, threadCount] {
+		//its own pool: the simulation keeps _workerPool busy (and may replace it) meanwhile
+		my::WorkerPool pool(threadCount);
+
+		BuildTarget build;
+		build.tiles = &_spareTiles;
+		build.columns = &_spareColumns;
+		build.climateStore = &_spareClimateStore;
+		build.airFlowExchange = &_spareAirFlowExchange;
+		build.seed = _spareSeed;
+		build.pool = &pool;
+
+		//the previous world's tiles, once there is one: the column table stays, columns and the store refill their allocations
+		if (int(_spareTiles.size()) != my::Address::GetRows()*my::Address::GetCols()) {
+			_spareTiles.clear();
+			setupTiles(build);
+		}
+		generateTileElevations(build);
+		finishWorldBuild(build);
+
+		//same grid, so the current insolation table covers the new tiles as well
+		std::vector<climate::SolarRadiation*> solarTiles;
+		for (Tile &tile : _spareTiles) {
+			solarTiles.push_back(&tile._tileClimate.getSolarRadiation());
+		}
+		climate::SolarRadiation::indexInsolationTable(solarTiles);
+
+		_regenerationReady = true;
+	});
+	return true;
+}
+
+bool World::regenerationReady() const noexcept { return _regenerationReady; }
+
+bool World::finishRegeneration() noexcept
+{
+	if (!_regenerationReady) return false;
+	_regenerationThread.join();
+	_regenerationReady = false;
+
+	//vectors swap their buffers, so every pointer into either world stays valid. the old one becomes the spare
+	_tiles.swap(_spareTiles);
+	_columns.swap(_spareColumns);
+	std::swap(_climateStore, _spareClimateStore);
+	std::swap(_airFlowExchange, _spareAirFlowExchange);
+	_seed = _spareSeed;
+
+	_selectedTile = nullptr;
+	_statisticsUpToDate = false;
+	return true;
+}
 
-std::vector<double> World::buildNoiseTable(int Rows, int Cols) noexcept {
+void World::buildColumnTable(const BuildTarget &build) noexcept {
+	build.columns->clear();
+	for (Tile &tile : *build.tiles) {
+		build.columns->push_back(&tile._tileClimate.getMaterialColumn());
+	}
+}
+
+
+std::vector<double> World::buildNoiseTable(const BuildTarget &build, int Rows, int Cols) noexcept {
 
 	noise::NoiseParameters noise_parameters;
 	noise_parameters.octaves = 8;			//number of noise octaves. (each octave has twice the frequency of the previous octave, and (persistance) the amplitude
-	noise_parameters.seed = _seed;			//seed for pseudorandom number generation
+	noise_parameters.seed = build.seed;		//seed for pseudorandom number generation
 	noise_parameters.zoom = 3000;			//determines wavelength of first octave
 	noise_parameters.persistance = 0.55;		//amplitude lost acending each octave
 
 							//create vector containing position pairs for each tile
 	std::vector<std::pair<double, double>> positions;
+	positions.reserve(size_t(Rows)*Cols);
 
 	my::Address A;
 	my::Vector2 V;
@@ -81,10 +230,10 @@ std::vector<double> World::buildNoiseTable(int Rows, int Cols) noexcept {
 	}
 
 	//return noise for each position
-	return noise::PerlinNoise(positions, noise_parameters);
+	return noise::PerlinNoise(positions, noise_parameters, build.pool);
 }
 
-std::vector<double> World::blendNoiseTable(std::vector<double> noiseTable, int Rows, int Cols, int vBlendDistance, int  hBlendDistance) noexcept {
+void World::blendNoiseTable(std::vector<double> &noiseTable, int Rows, int Cols, int vBlendDistance, int  hBlendDistance) noexcept {
 
 	//blend map east/west edge together
 	double weightedAverage;
@@ -141,12 +290,9 @@ std::vector<double> World::blendNoiseTable(std::vector<double> noiseTable, int R
 			noiseTable[row*Cols + col] = weightedAverage;
 		}
 	}
-
-	return noiseTable;
-
 }
 
-void World::generateTileElevations() noexcept {
+void World::generateTileElevations(const BuildTarget &build) noexcept {
 
 	int TileRows = my::Address::GetRows();
 	int TileCols = my::Address::GetCols();
@@ -160,11 +306,16 @@ void World::generateTileElevations() noexcept {
 	
 
 
-										//noise generator;
-	std::vector<double> noiseTable = buildNoiseTable(Rows, Cols);
+	std::vector<double> noiseTable;
+	{
+		my::ScopedTimer timer("world build: noise");
+
+		//noise generator;
+		noiseTable = buildNoiseTable(build, Rows, Cols);
 
-	//noise edge blender
-	noiseTable = blendNoiseTable(noiseTable, Rows, Cols, vBlendDistance, hBlendDistance);
+		//noise edge blender
+		blendNoiseTable(noiseTable, Rows, Cols, vBlendDistance, hBlendDistance);
+	}
 
 
 	//must be ~0. never outside of (-1, 1)
@@ -177,13 +328,15 @@ void World::generateTileElevations() noexcept {
 	const double abyssPower = .5;
 	const double landPower = 2;
 
-	my::Address A;
-	double noiseValue;
+	//SET ELEVATION, building each column in place
+	my::ScopedTimer timer("world build: columns");
+	std::vector<Tile> &tiles = *build.tiles;
+	forEachBuildRange(build.pool, TileRows*TileCols, [&](int begin, int end) {
+		for (int k = begin; k < end; k++) {
+			int row = k / TileCols;
+			int col = k % TileCols;
 
-	//SET ELEVATION
-	for (int row = 0; row < TileRows; row++) {
-		for (int col = 0; col < TileCols; col++) {
-			noiseValue = noiseTable[row*Cols + col];
+			double noiseValue = noiseTable[row*Cols + col];
 			//noiseValue = 0.1;
 			//shift
 			noiseValue += shiftBias;
@@ -214,60 +367,370 @@ void World::generateTileElevations() noexcept {
 			}
 
 			//determine tile to set
-			A = my::Address(row, col);
+			my::Address A = my::Address(row, col);
 			if (A.i == my::kFakeIndex) { LOG("address index out of bounds"); exit(EXIT_FAILURE); }
 
 			//Finally initialize TileClimate
-			_tiles[A.i]._tileClimate = climate::TileClimate(A, noiseValue);
+			tiles[A.i]._tileClimate.generate(A, noiseValue, my::CounterRandom(uint64_t(build.seed)).stream(A.i));
+		}
+	});
+}
+
+
+//a column only adds surfaces to its own layers (reading its neighbors'), so tiles link in parallel
+void World::setupTileClimateAdjacency(const BuildTarget &build, bool buildSurfaces) noexcept {
+
+	std::vector<Tile> &tiles = *build.tiles;
+	const std::vector<climate::layers::MaterialColumn*> &columns = *build.columns;
+	forEachBuildRange(build.pool, int(tiles.size()), [this, &tiles, &columns, buildSurfaces](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			if (buildSurfaces) { tiles[i]._tileClimate.buildAdjacency(_neighborGraph, columns); }
+			else { tiles[i]._tileClimate.linkAdjacency(_neighborGraph, columns); }
+		}
+	});
+}
+
+
+void World::simulate(const options::GameOptions &options) noexcept 
+{
+	climate::TileClimate::setTimeStep(options._stepHours, options._implicitRadiation ? climate::IMPLICIT_RADIATION : climate::EXPLICIT_RADIATION);
+	climate::TileClimate::setConductionScheme(options._implicitVerticalConduction ? climate::IMPLICIT_VERTICAL_CONDUCTION : climate::PAIRWISE_CONDUCTION);
+	climate::TileClimate::setAirFlowScheme(options._twoPhaseAirFlow ? climate::TWO_PHASE_AIR_FLOW : climate::SEQUENTIAL_AIR_FLOW);
+	_climateStore.setBatchedRadiation(options._batchedRadiation);
+	climate::InsolationMode insolationMode = options._lightInsolation ? climate::LIGHT_INSOLATION : climate::EXACT_INSOLATION;
+	if (insolationMode != climate::SolarRadiation::getInsolationMode()) { buildInsolationTable(insolationMode); }
+	climate::TileClimate::beginNewHour();
+
+	if (options._parallelSimulation && (!_workerPool || _workerPool->getThreadCount() != options._simulationThreads)) {
+		_workerPool.reset(new my::WorkerPool(options._simulationThreads));
+	}
+
+	while (climate::TileClimate::beginNextStep()) {
+		int step = climate::TileClimate::_simulationStep;
+		my::ScopedTimer stepTimer("simulate step " + std::to_string(step));
+		_storeStep = options._climateStore && climate::ClimateStore::handlesStep(step);
+
+		if (_storeStep && climate::ClimateStore::gathersBefore(step)) {
+			forEachTile(options, [this](int i) { _climateStore.gatherTile(i); });
+		}
+
+		if (climate::TileClimate::stepSolvesVerticalConduction()) {
+			forEachTileRange(options, [this](int begin, int end) { solveVerticalConduction(begin, end); });
+		}
+
+		//every flux before any layer changes (the pool's run is the barrier between the phases)
+		if (climate::TileClimate::stepExchangesAirFlow()) {
+			forEachTile(options, [this](int i) { _airFlowExchange.computeFluxes(i); });
+			forEachTile(options, [this](int i) { _airFlowExchange.applyFluxes(i); });
+		}
+
+		if (options._parallelSimulation) {
+			simulateStepParallel();
+		}
+		else {
+			for (int i = 0; i < int(_tiles.size()); i++) {
+				simulateTile(i);
+			}
+		}
+
+		if (_storeStep && _climateStore.batchesRadiationAfter(step)) {
+			forEachTileRange(options, [this](int begin, int end) { _climateStore.simulateRadiation(begin, end); });
+		}
+
+		if (_storeStep && climate::ClimateStore::scattersAfter(step)) {
+			forEachTile(options, [this](int i) { _climateStore.scatterTile(i); });
 		}
 	}
+
+	_statisticsUpToDate = false;
 }
 
+void World::simulateTile(int i) noexcept
+{
+	if (_storeStep) { _tiles[i]._tileClimate.simulateClimate(_climateStore, i); }
+	else { _tiles[i].simulate(); }
+}
 
-void World::setupTileClimateAdjacency() noexcept {
+//IMPLICIT_VERTICAL_CONDUCTION column solves for tiles [begin, end). each touches its own column only
+void World::solveVerticalConduction(int begin, int end) noexcept
+{
+	if (_storeStep) {
+		_climateStore.solveVerticalConduction(begin, end);
+		return;
+	}
+	for (int i = begin; i < end; i++) {
+		_tiles[i]._tileClimate.getMaterialColumn().simulateVerticalConduction();
+	}
+}
 
-	std::map<my::Direction, climate::TileClimate*>		adjacientTileClimates;
-	my::Direction						direction;
-	climate::TileClimate					*climatePtr;
+//every tile in the current step on the worker pool. returns once all tiles are done (step barrier)
+//steps that write neighboring tiles go one color class at a time, so the result doesn't depend on thread count
+void World::simulateStepParallel() noexcept
+{
+	if (climate::TileClimate::stepWritesNeighbors()) {
+		for (int color = 0; color < _tileColoring.getColorCount(); color++) {
+			simulateTilesParallel(_tileColoring.getColorClass(color));
+		}
+	}
+	else {
+		_workerPool->run(int(_tiles.size()), [this](int begin, int end) {
+			for (int i = begin; i < end; i++) {
+				simulateTile(i);
+			}
+		});
+	}
+}
 
-	for (Tile & tile : _tiles) {
-		//build adjacient climate map for tile
-		for (auto neighbor : tile._directionalNeighbors) {
-			direction = neighbor.first;
-			climatePtr = &(_tiles[neighbor.second.i]._tileClimate);//grab neighbor _tileClimate ptr
-			adjacientTileClimates[direction] = climatePtr;
+void World::simulateTilesParallel(const std::vector<int> &tileIndices) noexcept
+{
+	_workerPool->run(int(tileIndices.size()), [this, &tileIndices](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			simulateTile(tileIndices[i]);
 		}
+	});
+}
 
-		//pass map to tile's tileClimate
-		tile._tileClimate.buildAdjacency(adjacientTileClimates);
+//tile-local work outside the simulation steps (e.g. ClimateStore gather/scatter)
+void World::forEachTile(const options::GameOptions &options, const std::function<void(int)> &task) noexcept
+{
+	if (options._parallelSimulation) {
+		_workerPool->run(int(_tiles.size()), [&task](int begin, int end) {
+			for (int i = begin; i < end; i++) {
+				task(i);
+			}
+		});
+	}
+	else {
+		for (int i = 0; i < int(_tiles.size()); i++) {
+			task(i);
+		}
+	}
+}
 
-		//clear and restart for next tile
-		adjacientTileClimates.clear();
+//the same for batched kernels, a range of tiles at a time
+void World::forEachTileRange(const options::GameOptions &options, const std::function<void(int, int)> &task) noexcept
+{
+	if (options._parallelSimulation) {
+		_workerPool->run(int(_tiles.size()), task);
+	}
+	else {
+		task(0, int(_tiles.size()));
 	}
 }
 
+bool World::simulateBands(const options::GameOptions &options, int hours, int bandCount) noexcept
+{
+	BandDecomposition bands(bandCount, _tileColoring, _neighborGraph);
+
+	bool started = bands.start([this](int tile) {
+		my::SnapshotWriter writer;
+		writer.clear();
+		_tiles[tile]._tileClimate.writeState(writer);
+		return writer.size();
+	});
+	if (!started) return false;
+
+	climate::TileClimate::setTimeStep(options._stepHours, options._implicitRadiation ? climate::IMPLICIT_RADIATION : climate::EXPLICIT_RADIATION);
+	climate::TileClimate::setConductionScheme(options._implicitVerticalConduction ? climate::IMPLICIT_VERTICAL_CONDUCTION : climate::PAIRWISE_CONDUCTION);
+	climate::TileClimate::setAirFlowScheme(options._twoPhaseAirFlow ? climate::TWO_PHASE_AIR_FLOW : climate::SEQUENTIAL_AIR_FLOW);
+	_climateStore.setBatchedRadiation(options._batchedRadiation);
+	climate::InsolationMode insolationMode = options._lightInsolation ? climate::LIGHT_INSOLATION : climate::EXACT_INSOLATION;
+	if (insolationMode != climate::SolarRadiation::getInsolationMode()) { buildInsolationTable(insolationMode); }
+	for (int hour = 0; hour < hours; hour += options._stepHours) {
+		my::SimulationTime::updateGlobalTime(options._stepHours);
+		simulateBandHour(options, bands);
+	}
+
+	//store steps are scattered by now, so the objects hold everything
+	return bands.finish(
+		[this](int tile, my::SnapshotWriter &writer) { _tiles[tile]._tileClimate.writeState(writer); },
+		[this](int tile, my::SnapshotReader &reader) { _tiles[tile]._tileClimate.readState(reader); });
+}
 
-void World::simulate(const options::GameOptions &options) noexcept 
+//World::simulate's colored sweep over this band's tiles, exchanging halos after every phase.
+//during store steps the store is current, so tiles are scattered before they are sent and gathered once received
+void World::simulateBandHour(const options::GameOptions &options, BandDecomposition &bands) noexcept
 {
 	climate::TileClimate::beginNewHour();
 
+	//own tiles are whole rows, so a contiguous range
+	int ownBegin = bands.getOwnTiles().front();
+	int ownEnd = bands.getOwnTiles().back() + 1;
+
+	auto writeTile = [this](int tile, my::SnapshotWriter &writer) {
+		if (_storeStep) _climateStore.scatterTile(tile);
+		_tiles[tile]._tileClimate.writeState(writer);
+	};
+	auto readTile = [this](int tile, my::SnapshotReader &reader) {
+		_tiles[tile]._tileClimate.readState(reader);
+		if (_storeStep) _climateStore.gatherTile(tile);
+	};
+
 	while (climate::TileClimate::beginNextStep()) {
-		for (Tile &tile : _tiles) {
-			tile.simulate();
+		int step = climate::TileClimate::_simulationStep;
+		my::ScopedTimer stepTimer("simulate step " + std::to_string(step));
+		_storeStep = options._climateStore && climate::ClimateStore::handlesStep(step);
+
+		if (_storeStep && climate::ClimateStore::gathersBefore(step)) {
+			for (int tile : bands.getTouchedTiles()) {
+				_climateStore.gatherTile(tile);
+			}
+		}
+
+		if (climate::TileClimate::stepSolvesVerticalConduction()) {
+			solveVerticalConduction(ownBegin, ownEnd);
+			bands.exchange(BandDecomposition::kLocalPhase, writeTile, readTile);
+		}
+
+		//an own layer's fluxes come from surfaces of its own tile or a neighbor's, between layers that are current here.
+		//halo tiles' other surfaces read tiles that aren't, but nothing here reads those fluxes
+		if (climate::TileClimate::stepExchangesAirFlow()) {
+			for (int tile : bands.getTouchedTiles()) {
+				_airFlowExchange.computeFluxes(tile);
+			}
+			for (int tile : bands.getOwnTiles()) {
+				_airFlowExchange.applyFluxes(tile);
+			}
+		}
+
+		if (climate::TileClimate::stepWritesNeighbors()) {
+			for (int color = 0; color < _tileColoring.getColorCount(); color++) {
+				for (int tile : bands.getOwnTiles(color)) {
+					simulateTile(tile);
+				}
+				bands.exchange(color, writeTile, readTile);
+			}
+		}
+		else {
+			for (int tile : bands.getOwnTiles()) {
+				simulateTile(tile);
+			}
+			if (_storeStep && _climateStore.batchesRadiationAfter(step)) {
+				_climateStore.simulateRadiation(ownBegin, ownEnd);
+			}
+			bands.exchange(BandDecomposition::kLocalPhase, writeTile, readTile);
+		}
+
+		//halo tiles already hold what their writers sent
+		if (_storeStep && climate::ClimateStore::scattersAfter(step)) {
+			for (int tile : bands.getOwnTiles()) {
+				_climateStore.scatterTile(tile);
+			}
 		}
 	}
 
 	_statisticsUpToDate = false;
 }
 
-void World::performStatistics() noexcept 
+void World::buildClimateStore(const BuildTarget &build) noexcept
+{
+	build.climateStore->build(*build.columns, build.pool);
+}
+
+void World::buildAirFlowExchange(const BuildTarget &build) noexcept
+{
+	build.airFlowExchange->build(*build.columns, build.pool);
+}
+
+void World::buildInsolationTable(climate::InsolationMode mode) noexcept
+{
+	std::vector<climate::SolarRadiation*> tiles;
+	for (Tile &tile : _tiles) {
+		tiles.push_back(&tile._tileClimate.getSolarRadiation());
+	}
+	climate::SolarRadiation::buildInsolationTable(tiles, mode, _workerPool.get());
+}
+
+bool World::saveSnapshot(const std::string &path) const noexcept
+{
+	my::SnapshotWriter writer;
+
+	writer.write(int32_t(my::Address::GetRows()));
+	writer.write(int32_t(my::Address::GetCols()));
+	writer.write(_seed);
+	writer.write(_statRequest);
+	_statistics.writeSnapshot(writer);
+	my::SimulationTime::writeSnapshot(writer);
+
+	writer.write(my::kSnapshotTilesTag);
+	for (const Tile &tile : _tiles) {
+		tile._tileClimate.writeSnapshot(writer);
+	}
+
+	writer.write(my::kSnapshotSurfacesTag);
+	for (const Tile &tile : _tiles) {
+		tile._tileClimate.getMaterialColumn().writeSurfaceSnapshot(writer);
+	}
+
+	return writer.saveToFile(path);
+}
+
+bool World::loadSnapshot(const std::string &path) noexcept
+{
+	my::SnapshotReader reader;
+	if (!reader.open(path)) return false;
+
+	int rows = reader.read<int32_t>();
+	int cols = reader.read<int32_t>();
+	if (rows != my::Address::GetRows() || cols != my::Address::GetCols()) {
+		LOG("Snapshot " << path << " is " << rows << "x" << cols << ", world is " << my::Address::GetRows() << "x" << my::Address::GetCols());
+		return false;
+	}
+
+	//fresh tiles and column table. everything else comes from the snapshot.
+	//the graph is rebuilt in place (same dimensions), so spare columns linked to it stay valid
+	_neighborGraph.build();
+	_tiles.clear();
+	setupTiles(liveBuild());
+	_tileColoring.build(_neighborGraph);
+
+	reader.read(_seed);
+	reader.read(_statRequest);
+	_publishedStatRequest = _statRequest;//the restored statistics track it
+	_statistics.readSnapshot(reader);
+	my::SimulationTime::readSnapshot(reader);
+
+	reader.expect(my::kSnapshotTilesTag);
+	for (Tile &tile : _tiles) {
+		tile._tileClimate.readSnapshot(reader);
+	}
+	setupTileClimateAdjacency(liveBuild(), false);
+
+	reader.expect(my::kSnapshotSurfacesTag);
+	for (Tile &tile : _tiles) {
+		tile._tileClimate.getMaterialColumn().readSurfaceSnapshot(reader);
+	}
+	if (!reader.atEnd()) { LOG("Corrupt snapshot (trailing data)"); exit(EXIT_FAILURE); }
+
+	buildClimateStore(liveBuild());
+	buildAirFlowExchange(liveBuild());
+	buildInsolationTable(climate::SolarRadiation::getInsolationMode());
+
+	_selectedTile = nullptr;
+	_statisticsUpToDate = false;
+	return true;
+}
+
+bool World::readSnapshotDimensions(const std::string &path, int &rows, int &cols) noexcept
+{
+	my::SnapshotReader reader;
+	if (!reader.open(path)) return false;
+
+	rows = reader.read<int32_t>();
+	cols = reader.read<int32_t>();
+	return true;
+}
+
+void World::performStatistics(const StatRequest &statRequest) noexcept 
 {
+	my::ScopedTimer timer("statistics");
+
 	_statistics.clear();
 
 	double tileStatValue;
 
 	for (Tile &tile : _tiles) {//must be reference as the tile stores and needs the result of getStatistic
-		tileStatValue = tile.getStatistic(_statRequest);
+		tileStatValue = tile.getStatistic(statRequest);
 		if (tileStatValue != my::kFakeDouble) {//don't contribute fake values.
 			_statistics.contributeValue(tileStatValue);
 		}
@@ -278,27 +741,52 @@ void World::performStatistics() noexcept
 }
 
 
+#ifndef PLEISTOCENE_HEADLESS
 void World::processInput(const Input & input, const options::GameOptions &options) noexcept
 {
-	//New map (resets all simulation data and generates new tile elevations with a random seed
+	_simulationThread->setOptions(options);
+
+	bool newView = false;
+
+	//New map (resets all simulation data and generates new tile elevations with a random seed).
+	//built in the background while the old one keeps running, then swapped in between hours
 	if (input.wasKeyPressed(SDL_SCANCODE_G)) {
-		_seed = rand();
-		LOG("Seed = " << _seed);
-		generateWorld(options);
-		my::SimulationTime::resetGlobalTime();
-		_statistics.newStatistic();
-		simulate(options);
+		double seed = rand();
+		if (startRegeneration(options, seed)) { LOG("Generating seed " << seed); }
+	}
+	if (regenerationReady()) {
+		_simulationThread->exclusive([this, &options] {
+			finishRegeneration();
+			LOG("Seed = " << _seed);
+			my::SimulationTime::resetGlobalTime();
+			_statistics.newStatistic();
+			simulate(options);
+		});
+		newView = true;
 	}
 
-	//simulation
-	if (input.wasKeyPressed(SDL_SCANCODE_RETURN) ||	//Press enter for one hour of simulation
-		input.wasKeyHeld(SDL_SCANCODE_BACKSLASH) ||	//Hold backslash for continuous simulation
-		options._continuousSimulation)			//Press spacebar to toggle continuous simulation
-	{
-		my::SimulationTime::updateGlobalTime();
-		simulate(options);
+	//quicksave/quickload the whole simulation state
+	if (input.wasKeyPressed(SDL_SCANCODE_F5)) {
+		_simulationThread->exclusive([this] {
+			if (saveSnapshot(kQuickSnapshotPath)) { LOG("Saved " << kQuickSnapshotPath); }
+		});
+	}
+	if (input.wasKeyPressed(SDL_SCANCODE_F9)) {
+		_simulationThread->exclusive([this] {
+			if (loadSnapshot(kQuickSnapshotPath)) { LOG("Loaded " << kQuickSnapshotPath); }
+		});
+		newView = true;
 	}
 
+	//simulation (runs on the simulation thread, the UI keeps drawing the last published hour)
+	if (input.wasKeyPressed(SDL_SCANCODE_RETURN)) {//Press enter for one hour of simulation
+		_simulationThread->requestHours(1);
+	}
+	if (input.wasKeyHeld(SDL_SCANCODE_BACKSLASH) && _simulationThread->isIdle()) {//Hold backslash for continuous simulation
+		_simulationThread->requestHours(1);
+	}
+	_simulationThread->setContinuous(options._continuousSimulation);//Press spacebar to toggle continuous simulation
+
 
 	bool newStatistic = false;
 
@@ -373,9 +861,8 @@ void World::processInput(const Input & input, const options::GameOptions &option
 	if (_statRequest._layer > 6)  _statRequest._layer = 6;
 
 	
-	if (newStatistic) {
-		_statistics.newStatistic();
-		_statisticsUpToDate = false;
+	if (newStatistic || newView) {
+		_simulationThread->requestPublish(currentView());
 	}
 	
 }
@@ -394,15 +881,17 @@ void World::setupTextures(graphics::Graphics &graphics) noexcept {
 
 void World::draw(graphics::Graphics &graphics, bool cameraMovementFlag, const options::GameOptions &options, user_interface::Bios &bios) noexcept 
 {
+	my::ScopedTimer timer("world draw");
 
-	if (!_statisticsUpToDate) {
-		performStatistics();
-	}
+	std::shared_ptr<const RenderSnapshot> snapshot = getRenderSnapshot();
+	if (!snapshot || snapshot->_tiles.size() != _tiles.size()) return;
 
+	const StatRequest &statRequest = snapshot->_view._statRequest;
+	Tile *previousSelection = _selectedTile;
 
-	if (_statRequest._statType == ELEVATION && _statRequest._section == SURFACE_) {
+	if (statRequest._statType == ELEVATION && statRequest._section == SURFACE_) {
 		for (Tile &tile : _tiles) {
-			if (tile.elevationDraw(graphics, cameraMovementFlag, options._sunlit)) {
+			if (tile.elevationDraw(graphics, cameraMovementFlag, options._sunlit, snapshot->_tiles[tile._address.i])) {
 				_selectedTile = &tile;
 			}
 		}
@@ -410,14 +899,20 @@ void World::draw(graphics::Graphics &graphics, bool cameraMovementFlag, const op
 
 	else {
 		for (Tile &tile : _tiles) {
-			if (tile.statDraw(graphics, cameraMovementFlag, _statistics, _statRequest)) {
+			if (tile.statDraw(graphics, cameraMovementFlag, snapshot->_statistics, statRequest, snapshot->_tiles[tile._address.i])) {
 				_selectedTile = &tile;
 			}
 		}
 	}
 
+	//messages for a newly clicked tile come with the next snapshot
+	if (_selectedTile != previousSelection) {
+		_simulationThread->requestPublish(currentView());
+	}
+
 	if (_selectedTile) {
-		std::vector<SDL_Rect> onscreenPositions = graphics.getOnscreenPositions(&_selectedTile->getGameRect());
+		SDL_Rect selectedRect = _selectedTile->getGameRect();
+		std::vector<SDL_Rect> onscreenPositions = graphics.getOnscreenPositions(&selectedRect);
 		if (onscreenPositions.empty()) {
 			return;
 		}
@@ -425,10 +920,91 @@ void World::draw(graphics::Graphics &graphics, bool cameraMovementFlag, const op
 	}
 }
 
+void World::startSimulationThread(const options::GameOptions &options) noexcept
+{
+	publishRenderSnapshot(currentView());
+	_simulationThread.reset(new SimulationThread(*this, options));
+}
+
+RenderView World::currentView() const noexcept
+{
+	RenderView view;
+	view._statRequest = _statRequest;
+	if (_selectedTile) view._selectedIndex = _selectedTile->_address.i;
+	return view;
+}
+
+#endif
+
+//======================================
+//RENDER SNAPSHOTS
+//======================================
+
+void World::publishRenderSnapshot(const RenderView &view) noexcept
+{
+	const StatRequest &statRequest = view._statRequest;
+
+	if (statRequest != _publishedStatRequest) {
+		_statistics.newStatistic();
+		_statisticsUpToDate = false;
+		_publishedStatRequest = statRequest;
+	}
+	if (!_statisticsUpToDate) {
+		performStatistics(statRequest);
+	}
+
+	if (!_backSnapshot || _backSnapshot.use_count() > 1) {//the UI is still drawing the old front
+		_backSnapshot = std::make_shared<RenderSnapshot>();
+	}
+	RenderSnapshot &snapshot = *_backSnapshot;
+
+	snapshot._view = view;
+	snapshot._tiles.resize(_tiles.size());
+	for (const Tile &tile : _tiles) {
+		const climate::layers::MaterialColumn &column = tile._tileClimate.getMaterialColumn();
+		TileRenderValues &values = snapshot._tiles[tile._address.i];
+
+		values._statValue = tile._statValue;
+		values._elevation = column.getLandElevation();
+		values._solarShader = tile._tileClimate.getSolarShader();
+		if (statRequest._statType == FLOW) {
+			Eigen::Vector2d advection = column.getAdvection(statRequest);
+			values._advection = my::Vector2d(advection(0), advection(1));
+		}
+	}
+
+	snapshot._statistics = _statistics;
+	snapshot._selectedMessages = buildSelectedMessages(view);
+	snapshot._readout = buildReadout(statRequest);
+	snapshot._timeReadout = my::SimulationTime::readGlobalTime();
+	snapshot._hour = my::SimulationTime::_globalTime.getHour();
+
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	std::swap(_frontSnapshot, _backSnapshot);
+}
+
+std::shared_ptr<const RenderSnapshot> World::getRenderSnapshot() const noexcept
+{
+	std::lock_guard<std::mutex> lock(_snapshotMutex);
+	return _frontSnapshot;
+}
+
 std::vector<std::string> World::getMessages() const noexcept 
 {
-	if (_selectedTile != nullptr) {
-		double sigmas=_statistics.getSigmasOffMean(_selectedTile->getStatistic(_statRequest));
+	std::shared_ptr<const RenderSnapshot> snapshot = getRenderSnapshot();
+
+	//until the snapshot for a new selection arrives there is nothing to show
+	if (!snapshot || _selectedTile == nullptr || snapshot->_view._selectedIndex != _selectedTile->_address.i) {
+		return std::vector<std::string> {};
+	}
+	return snapshot->_selectedMessages;
+}
+
+std::vector<std::string> World::buildSelectedMessages(const RenderView &view) const noexcept
+{
+	if (view._selectedIndex != my::kFakeIndex) {
+		const Tile &tile = _tiles[view._selectedIndex];
+		double sigmas=_statistics.getSigmasOffMean(tile._statValue);
 
 		std::stringstream stream;
 		stream << "Sigmas off mean: " << my::double2string(sigmas);
@@ -436,7 +1012,7 @@ std::vector<std::string> World::getMessages() const noexcept
 		messages.push_back(stream.str());
 
 		std::vector<std::string> subMessages;
-		subMessages= _selectedTile->sendMessages(_statRequest);
+		subMessages= tile.sendMessages(view._statRequest);
 		messages.insert(messages.end(), subMessages.begin(), subMessages.end());
 		return messages;
 	}
@@ -446,13 +1022,31 @@ std::vector<std::string> World::getMessages() const noexcept
 void World::clearSelected() noexcept { _selectedTile = nullptr; }
 
 std::vector<std::string> World::getReadout() const noexcept
+{
+	std::shared_ptr<const RenderSnapshot> snapshot = getRenderSnapshot();
+	return snapshot ? snapshot->_readout : std::vector<std::string> {};
+}
+
+std::vector<std::string> World::getTimeReadout() const noexcept
+{
+	std::shared_ptr<const RenderSnapshot> snapshot = getRenderSnapshot();
+	return snapshot ? snapshot->_timeReadout : std::vector<std::string> {};
+}
+
+int World::getDisplayedHour() const noexcept
+{
+	std::shared_ptr<const RenderSnapshot> snapshot = getRenderSnapshot();
+	return snapshot ? snapshot->_hour : 0;
+}
+
+std::vector<std::string> World::buildReadout(const StatRequest &statRequest) const noexcept
 {
 	std::vector<std::string> readout;
 
 	std::string statement;
 	std::stringstream stream;
 
-	switch (_statRequest._section) {
+	switch (statRequest._section) {
 	case(SURFACE_) : stream<<"Surface "; break;
 	case(HORIZON_) : stream<< "Horizon "; break;
 	case(EARTH_) : stream<< "Earth "; break;
@@ -460,7 +1054,7 @@ std::vector<std::string> World::getReadout() const noexcept
 	case(AIR_) : stream<< "Air "; break;
 	}
 
-	switch (_statRequest._statType) {
+	switch (statRequest._statType) {
 	case(ELEVATION) : stream<< "elevation. "; break;
 	case(TEMPERATURE) : stream<< "temperature. "; break;
 	case(MATERIAL_PROPERTIES) : stream<< "material properties. "; break;
@@ -471,7 +1065,7 @@ std::vector<std::string> World::getReadout() const noexcept
 	readout.push_back(stream.str());
 
 	stream.str(std::string());
-	stream << "Layer: " << _statRequest._layer << ". ";
+	stream << "Layer: " << statRequest._layer << ". ";
 	
 	readout.push_back(stream.str());
 
@@ -487,6 +1081,8 @@ std::vector<std::string> World::getReadout() const noexcept
 	return readout;
 }
 
+const std::vector<Tile> &World::getTiles() const noexcept { return _tiles; }
+
 
 }//namespace simulation
 }//namespace pleistocene
\ No newline at end of file
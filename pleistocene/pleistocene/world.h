@@ -2,6 +2,15 @@
 #include "globals.h"
 #include "statistics.h"
 #include "tile.h"
+#include "worker-pool.h"
+#include "neighbor-graph.h"
+#include "tile-coloring.h"
+#include "climate-store.h"
+#include "air-flow-exchange.h"
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
 
 namespace pleistocene {
  
@@ -48,60 +57,212 @@ struct StatRequest {
 		_layer(layer)
 	{}
 
+	bool operator==(const StatRequest &other) const noexcept
+	{
+		return _statType == other._statType && _section == other._section && _layer == other._layer;
+	}
+	bool operator!=(const StatRequest &other) const noexcept { return !(*this == other); }
 };
 
+//what the UI is looking at. snapshots are published for the latest view
+struct RenderView {
+	StatRequest _statRequest;
+	int _selectedIndex = my::kFakeIndex;//tile the bios shows messages for
+};
+
+//per-tile values World::draw needs
+struct TileRenderValues {
+	double _statValue = my::kFakeDouble;
+	double _elevation = 0;
+	double _solarShader = 1;
+	my::Vector2d _advection;//only filled in for FLOW
+};
+
+//Read-only copy of everything the UI shows, published by the simulation after each hour (or view change).
+//The UI draws from it instead of the tiles, so it never waits on (or races with) a simulation step
+struct RenderSnapshot {
+	RenderView _view;
+	std::vector<TileRenderValues> _tiles;
+	Statistics _statistics;
+	std::vector<std::string> _selectedMessages;
+	std::vector<std::string> _readout;
+	std::vector<std::string> _timeReadout;
+	int _hour = 0;
+};
+
+class SimulationThread;
+class BandDecomposition;
+
+//F5/F9 quicksave file
+const std::string kQuickSnapshotPath = "quicksave.snapshot";
 
 class World {
 public:
 	World() noexcept;
+	//headless world (no textures)
+	World(const options::GameOptions &options) noexcept;
+#ifndef PLEISTOCENE_HEADLESS
 	World(graphics::Graphics &graphics, const options::GameOptions &options) noexcept;
+#endif
+	~World() noexcept;
 
 private:
 
-	void setupTiles(graphics::Graphics & graphics) noexcept;
-	void buildTileVector() noexcept;
+	//what a world build writes to: the live world, or the spare one G regenerates into (see startRegeneration)
+	struct BuildTarget {
+		std::vector<Tile> *tiles;
+		std::vector<climate::layers::MaterialColumn*> *columns;//the tiles' columns, by tile
+		climate::ClimateStore *climateStore;
+		climate::AirFlowExchange *airFlowExchange;
+		double seed;
+		my::WorkerPool *pool;//nullptr builds on the calling thread
+	};
+	BuildTarget liveBuild() noexcept;
+
+	void setupTiles(const BuildTarget &build) noexcept;
+	static void buildTileVector(std::vector<Tile> &tiles) noexcept;
+#ifndef PLEISTOCENE_HEADLESS
 	void setupTextures(graphics::Graphics & graphics) noexcept;
-	void buildTileNeighbors() noexcept;
+#endif
+	//columns reach their neighbors through it, so it is filled once the tiles are placed and never moves after
+	void buildColumnTable(const BuildTarget &build) noexcept;
 
-	void generateTileElevations() noexcept;
-	void setupTileClimateAdjacency() noexcept;
+	void generateTileElevations(const BuildTarget &build) noexcept;
+	//buildSurfaces false only links neighbors (surfaces come from a snapshot)
+	void setupTileClimateAdjacency(const BuildTarget &build, bool buildSurfaces = true) noexcept;
 
-	std::vector<double> World::buildNoiseTable(int Rows, int Cols) noexcept;
+	//surfaces and climate store, once every column is generated
+	void finishWorldBuild(const BuildTarget &build) noexcept;
+	//world build stages: on pool when there is one (whatever the simulation options), else on this thread
+	static void forEachBuildRange(my::WorkerPool *pool, int count, const std::function<void(int, int)> &task) noexcept;
 
-	std::vector<double> World::blendNoiseTable(std::vector<double> noiseTable, int Rows, int Cols, int vBlendDistance, int  hBlendDistance) noexcept;
+	std::vector<double> buildNoiseTable(const BuildTarget &build, int Rows, int Cols) noexcept;
+
+	void blendNoiseTable(std::vector<double> &noiseTable, int Rows, int Cols, int vBlendDistance, int  hBlendDistance) noexcept;
 
 public:
 
 	void generateWorld(const options::GameOptions &options) noexcept;
-
+	//flat world for pleistocene-bench: each tile is 500 m land with probability landFraction (by seed), otherwise 2000 m deep sea
+	void generateSyntheticWorld(double landFraction) noexcept;
+
+	//generates the world for seed on a background thread, into the spare tiles (the previous world's, reused)
+	//while this one keeps simulating and rendering. false if a regeneration is already under way
+	bool startRegeneration(const options::GameOptions &options, double seed) noexcept;
+	bool regenerationReady() const noexcept;
+	//swaps a finished regeneration in, between hours (see SimulationThread::exclusive). false if none is ready.
+	//time and statistics are the caller's to reset
+	bool finishRegeneration() noexcept;
+
+#ifndef PLEISTOCENE_HEADLESS
 	void draw(graphics::Graphics &graphics, bool cameraMovementFlag, const options::GameOptions &options, user_interface::Bios &bios) noexcept;
+#endif
 
 	void simulate(const options::GameOptions &options) noexcept;
 
+	//hours run with the rows split into latitude bands, one process each (see BandDecomposition), advancing SimulationTime
+	//every step. results match simulate with _parallelSimulation, and every tile is back in this world when it returns.
+	//false (and LOG) if a band failed
+	bool simulateBands(const options::GameOptions &options, int hours, int bandCount) noexcept;
+
+	//RENDER SNAPSHOTS
+	//fills the back snapshot for view and swaps it to the front. called between hours by whoever runs the simulation
+	void publishRenderSnapshot(const RenderView &view) noexcept;
+	//latest published snapshot (null before the first publish). safe to call while the simulation runs
+	std::shared_ptr<const RenderSnapshot> getRenderSnapshot() const noexcept;
+
 	user_interface::Bios* _bioPtr;
 
+#ifndef PLEISTOCENE_HEADLESS
+	//publishes the first snapshot and hands the simulation to its own thread. from then on
+	//the UI thread reaches the tiles only through snapshots and SimulationThread::exclusive
+	void startSimulationThread(const options::GameOptions &options) noexcept;
+
 	void processInput(const Input &input, const options::GameOptions & options) noexcept;
+#endif
 
 	void clearSelected() noexcept;
 
+	//CHECKPOINT
+	//the whole simulation state in one binary file, written sequentially
+	bool saveSnapshot(const std::string &path) const noexcept;
+	//maps the file and relinks the tiles, without regenerating terrain or rebuilding surfaces.
+	//the snapshot must have the current world dimensions (see readSnapshotDimensions)
+	bool loadSnapshot(const std::string &path) noexcept;
+	static bool readSnapshotDimensions(const std::string &path, int &rows, int &cols) noexcept;
+
+	//from the current render snapshot
 	std::vector<std::string> getMessages() const noexcept;
 	std::vector<std::string> getReadout() const noexcept;
+	std::vector<std::string> getTimeReadout() const noexcept;
+	int getDisplayedHour() const noexcept;
+
+	const std::vector<Tile> &getTiles() const noexcept;
 
 private:
 
 	double _seed;
 
 	std::vector<Tile> _tiles;
+	std::vector<climate::layers::MaterialColumn*> _columns;
+
+	//the same grid for the live world and the spare
+	NeighborGraph _neighborGraph;
+
+	std::unique_ptr<my::WorkerPool> _workerPool;
+	TileColoring _tileColoring;
+	void simulateTile(int i) noexcept;
+	void solveVerticalConduction(int begin, int end) noexcept;
+	void simulateStepParallel() noexcept;
+	void simulateTilesParallel(const std::vector<int> &tileIndices) noexcept;
+	void forEachTile(const options::GameOptions &options, const std::function<void(int)> &task) noexcept;
+	void forEachTileRange(const options::GameOptions &options, const std::function<void(int, int)> &task) noexcept;
+	void simulateBandHour(const options::GameOptions &options, BandDecomposition &bands) noexcept;
+
+	//structure-of-arrays copy of the climate state for the steps it handles
+	climate::ClimateStore _climateStore;
+	bool _storeStep = false;//current step runs on _climateStore
+	void buildClimateStore(const BuildTarget &build) noexcept;
+
+	//the air surfaces, flattened for TWO_PHASE_AIR_FLOW
+	climate::AirFlowExchange _airFlowExchange;
+	void buildAirFlowExchange(const BuildTarget &build) noexcept;
+	//SolarRadiation's table over _tiles, in tile order
+	void buildInsolationTable(climate::InsolationMode mode) noexcept;
 
 	bool _statisticsUpToDate;
 
-	void performStatistics() noexcept;
+	void performStatistics(const StatRequest &statRequest) noexcept;
 
-	StatRequest _statRequest;
+	StatRequest _statRequest;//UI side (what the user picked)
+	StatRequest _publishedStatRequest;//what _statistics is tracking
 
 	Statistics _statistics;
 
 	Tile *_selectedTile;
+
+	std::vector<std::string> buildSelectedMessages(const RenderView &view) const noexcept;
+	std::vector<std::string> buildReadout(const StatRequest &statRequest) const noexcept;
+
+	//double buffer. the back snapshot is only replaced when the UI still holds it
+	std::shared_ptr<RenderSnapshot> _frontSnapshot;
+	std::shared_ptr<RenderSnapshot> _backSnapshot;
+	mutable std::mutex _snapshotMutex;
+
+#ifndef PLEISTOCENE_HEADLESS
+	RenderView currentView() const noexcept;
+#endif
+	//background regeneration, swapped in by finishRegeneration
+	std::vector<Tile> _spareTiles;
+	std::vector<climate::layers::MaterialColumn*> _spareColumns;
+	climate::ClimateStore _spareClimateStore;
+	climate::AirFlowExchange _spareAirFlowExchange;
+	double _spareSeed = 0;
+	std::thread _regenerationThread;
+	std::atomic<bool> _regenerationReady{ false };
+
+	//last member, so it stops before anything it simulates is destroyed
+	std::unique_ptr<SimulationThread> _simulationThread;
 };
 
 